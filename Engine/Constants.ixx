@@ -8,4 +8,11 @@ export namespace mt
 #else
 	constexpr bool IS_DEBUG = false;
 #endif
+
+	// Whether every EventQueue counts its pushes and stamps its packages, see EventQueueStatistics.
+#if defined(MT_NO_EVENT_QUEUE_STATISTICS)
+	constexpr bool HAS_EVENT_QUEUE_STATISTICS = false;
+#else
+	constexpr bool HAS_EVENT_QUEUE_STATISTICS = true;
+#endif
 }
\ No newline at end of file
@@ -25,7 +25,9 @@ using namespace mt::error;
 
 Engine* Engine::_instance = nullptr;
 
-Engine::Engine() noexcept
+Engine::Engine(MemoryResources memory_resources) noexcept
+	: _tracking_memory_resources(memory_resources)
+	, _memory_resources(_tracking_memory_resources.getMemoryResources())
 {
 	if (_instance != nullptr)
 	{
@@ -38,7 +40,9 @@ Engine::Engine() noexcept
 
 	if (_error == nullptr) return;
 
-	if (_input_manager = make_unique_nothrow<input::BasicInputManager>(*this, *_error);
+	if (_input_manager = make_tracked_unique_nothrow<input::BasicInputManager>(
+			MemoryTag::INPUT, *this, *_error, _memory_resources.input
+		);
 		_input_manager.get() == nullptr
 	)
 	{
@@ -48,7 +52,9 @@ Engine::Engine() noexcept
 		return;
 	}
 
-	if (_time_manager = make_unique_nothrow<time::StandardTimeManager>(*this, *_error);
+	if (_time_manager = make_tracked_unique_nothrow<time::StandardTimeManager>(
+			MemoryTag::TIME, *this, *_error, _memory_resources.time
+		);
 		_time_manager.get() == nullptr || _error->value() != static_cast<int>(ErrorCode::ERROR_UNINITIALIZED)
 	)
 	{
@@ -58,8 +64,20 @@ Engine::Engine() noexcept
 		return;
 	}
 
-	if (_window_manager = make_unique_nothrow<windows::WindowsWindowManager>(
-			*this, *_error, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN)
+	// Serial until the engine has queues that can be drained independently, see EventManagerInterface.
+	if (_event_manager = make_tracked_unique_nothrow<event::EventManagerInterface>(
+			MemoryTag::EVENT, *_error, event::EventDispatchMode::SERIAL, _memory_resources.event
+		);
+		_event_manager.get() == nullptr || _error->value() != static_cast<int>(ErrorCode::ERROR_UNINITIALIZED)
+	)
+	{
+		if (_event_manager.get() == nullptr) Assign(*_error, mt::error::ErrorCode::BAD_ALLOCATION);
+
+		return;
+	}
+
+	if (_window_manager = make_tracked_unique_nothrow<windows::WindowsWindowManager>(
+			MemoryTag::WINDOWS, *this, *_error, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN)
 		);
 		_window_manager.get() == nullptr || _error->value() != static_cast<int>(ErrorCode::ERROR_UNINITIALIZED)
 	)
@@ -69,12 +87,13 @@ Engine::Engine() noexcept
 		return;
 	}
 
-	// TODO: this should be taking in the error and returning error information if it fails.
-	if (_renderer = make_unique_nothrow<renderer::DirectXRenderer>(*this);
-		_renderer.get() == nullptr //|| _error->getErrorCode() != mt::error::ErrorCode::ERROR_UNINITIALIZED
+	if (_renderer = make_tracked_unique_nothrow<renderer::DirectXRenderer>(
+			MemoryTag::RENDERER, *this, *_error, _memory_resources.renderer, _memory_resources.geometry
+		);
+		_renderer.get() == nullptr || _error->value() != static_cast<int>(ErrorCode::ERROR_UNINITIALIZED)
 	)
 	{
-		Assign(*_error, mt::error::ErrorCode::BAD_ALLOCATION);
+		if (_renderer.get() == nullptr) Assign(*_error, mt::error::ErrorCode::BAD_ALLOCATION);
 
 		return;
 	}
@@ -7,6 +7,7 @@ export import Constants;
 export import Error;
 export import Game;
 
+export import EventManagerInterface;
 export import RendererInterface;
 export import TimeManagerInterface;
 export import InputManagerInterface;
@@ -15,6 +16,7 @@ export import WindowsMessageManagerInterface;
 
 export import gsl;
 export import InputModel;
+export import MemoryResources;
 export import Task;
 
 import MakeUnique;
@@ -22,6 +24,7 @@ import Windows;
 
 using namespace std::literals;
 
+using mt::event::EventManagerInterface;
 using mt::input::InputManagerInterface;
 using mt::renderer::RendererInterface;
 using mt::windows::WindowsMessageManagerInterface;
@@ -45,10 +48,15 @@ export namespace mt
 			)
 		);
 
-		unique_ptr<InputManagerInterface>	_input_manager 	= nullptr;
-		unique_ptr<TimeManagerInterface>	_time_manager 	= nullptr;
-		unique_ptr<WindowManagerInterface>	_window_manager = nullptr;
-		unique_ptr<RendererInterface>		_renderer		= nullptr;
+		// Charges everything the subsystems allocate from their memory resources to their MemoryTag.
+		mt::memory::TrackingMemoryResources _tracking_memory_resources;
+		mt::memory::MemoryResources _memory_resources;
+
+		tracked_unique_ptr<InputManagerInterface>	_input_manager 	= nullptr;
+		tracked_unique_ptr<TimeManagerInterface>	_time_manager 	= nullptr;
+		tracked_unique_ptr<EventManagerInterface>	_event_manager	= nullptr;
+		tracked_unique_ptr<WindowManagerInterface>	_window_manager = nullptr;
+		tracked_unique_ptr<RendererInterface>		_renderer		= nullptr;
 		unique_ptr<Game>					_game 			= nullptr;
 
 		// Shutdown is checked to see if Tick should keep ticking, on true ticking stops and Tick() returns
@@ -61,7 +69,8 @@ export namespace mt
 	public:
 		friend TimeManagerInterface;
 
-		Engine() noexcept;
+		Engine() noexcept : Engine(mt::memory::MemoryResources{}) {}
+		explicit Engine(mt::memory::MemoryResources memory_resources) noexcept;
 		~Engine() noexcept;
 		Engine(const Engine& other) noexcept = default;
 		Engine(Engine&& other) noexcept = default;
@@ -73,8 +82,11 @@ export namespace mt
 		[[nodiscard]] RendererInterface * 		getRenderer() 		noexcept	{ return _renderer.get(); };
 		[[nodiscard]] WindowManagerInterface * 	getWindowManager() 	noexcept	{ return _window_manager.get(); };
 		[[nodiscard]] TimeManagerInterface * 	getTimeManager() 	noexcept	{ return _time_manager.get(); };
+		[[nodiscard]] EventManagerInterface * 	getEventManager() 	noexcept	{ return _event_manager.get(); };
 		[[nodiscard]] Game * 					getGame() 			noexcept	{ return _game.get(); };
 
+		[[nodiscard]] const mt::memory::MemoryResources& getMemoryResources() const noexcept { return _memory_resources; }
+
 		[[nodiscard]] static bool isDestroyed() noexcept { return _instance == nullptr; };
 		[[nodiscard]] bool isShuttingDown() const noexcept { return _is_shutting_down.load(); }
 		[[nodiscard]] bool shouldShutDown() const noexcept { return _should_shut_down.load(); }
@@ -19,6 +19,7 @@ export namespace mt::error
 		MEMORY_FAILURE = 1000, // MEMORY
 		BAD_ALLOCATION,
 		OUT_OF_MEMORY,
+		TOO_MANY_EPOCH_PARTICIPANTS,
 
 		GRAPHICS_FAILURE = 2000,  // GRAPHICS
 		CREATE_COMMITTED_RESOURCE_FAILED,
@@ -75,6 +76,9 @@ export namespace mt::error
 
 		EVENT_MANAGER_FAILURE = 5000, // EVENT MANAGER
 		EVENT_QUEUE_ALREADY_EXISTS,
+		EVENT_LOG_OPEN_FAILED,
+		EVENT_LOG_INVALID,
+		EVENT_QUEUE_NOT_FOUND,
 
 
 		INVALID_GAME_PROVIDED = 9999, // INVALID GAME
@@ -108,6 +112,8 @@ export namespace mt::error
 					return "Memory Failure.";
 				case ErrorCode::OUT_OF_MEMORY:
 					return "Out of Memory.";
+				case ErrorCode::TOO_MANY_EPOCH_PARTICIPANTS:
+					return "Every participant slot of the epoch domain is taken.";
 				case ErrorCode::GRAPHICS_FAILURE:
 					return "Unable to compile shader.";
 				case ErrorCode::CREATE_COMMITTED_RESOURCE_FAILED:
@@ -132,6 +138,12 @@ export namespace mt::error
 					return "Event Manager Failure.";
 				case ErrorCode::EVENT_QUEUE_ALREADY_EXISTS:
 					return "An event queue already exists for supplied name.";
+				case ErrorCode::EVENT_LOG_OPEN_FAILED:
+					return "Unable to open or map the event log file.";
+				case ErrorCode::EVENT_LOG_INVALID:
+					return "The file is not an event log this version can read.";
+				case ErrorCode::EVENT_QUEUE_NOT_FOUND:
+					return "No event queue exists for supplied name.";
 				case ErrorCode::WINDOWS_MESSAGE_MANAGER_FAILURE:
 					return "Windows Message Manager Failure.";
 				case ErrorCode::ONE_WINDOWS_MESSAGE_MANAGER_RULE:
@@ -3,9 +3,11 @@ export module Event;
 import std;
 
 import EventQueue;
-import EventPackageInterface;
+import EventPackageHeader;
 import EventHandlerInterface;
+import EventRecorder;
 import Name;
+import SlotMap;
 
 using namespace std::literals;
 
@@ -13,80 +15,267 @@ using namespace mt::utility;
 
 export namespace mt::event
 {
+	// Identifies a handler's registration with an Event, stays valid until the handler is deregistered.
+	template<typename ... ParameterTypes>
+	using EventHandlerToken = mt::memory::SlotHandle<EventHandler<ParameterTypes ...>*>;
+
+	// Folds the parameters of a trigger into those of the package an event already has waiting in its queue.
+	template<typename ... ParameterTypes>
+	using EventReducer = void (*)(
+		EventParameters<ParameterTypes ...>& pending, const EventParameters<ParameterTypes ...>& next
+	) noexcept;
+
+	// Ready made reducers, see Event's coalescing constructor.
+
+	// Only the parameters of the last trigger reach the handlers.
+	template<typename ... ParameterTypes>
+	void coalesceKeepLast(
+		EventParameters<ParameterTypes ...>& pending, const EventParameters<ParameterTypes ...>& next
+	) noexcept
+	{
+		pending = next;
+	}
+
+	// Handlers get the sum of every trigger's parameters, for deltas such as mouse movement.
+	template<typename ... ParameterTypes>
+	void coalesceSum(
+		EventParameters<ParameterTypes ...>& pending, const EventParameters<ParameterTypes ...>& next
+	) noexcept
+	{
+		auto add = [](auto& pending_parameter, const auto& next_parameter) noexcept {
+			pending_parameter += next_parameter;
+		};
+
+		forEachEventParameter(add, pending, next);
+	}
+
+	// Handlers get the largest value of each parameter.
+	template<typename ... ParameterTypes>
+	void coalesceMax(
+		EventParameters<ParameterTypes ...>& pending, const EventParameters<ParameterTypes ...>& next
+	) noexcept
+	{
+		auto keep_max = [](auto& pending_parameter, const auto& next_parameter) noexcept {
+			pending_parameter = std::max(pending_parameter, next_parameter);
+		};
+
+		forEachEventParameter(keep_max, pending, next);
+	}
+
 	template<typename ... ParameterTypes>
 	class Event
 	{
 	private:
 		EventQueue& _event_queue;
 
-		std::set<EventHandler<ParameterTypes ...>*> event_handlers;
+		// Dense, so dispatch walks a flat array. Registering and deregistering are O(1).
+		mt::memory::SlotMap<EventHandler<ParameterTypes ...>*> _event_handlers;
+
+		// Handlers deregistered during a dispatch are nulled out and only erased once it finishes, erasing moves the
+		// last handler into the hole, which would skip it.
+		std::pmr::vector<EventHandlerToken<ParameterTypes ...>> _pending_removals;
+		std::uint32_t _dispatch_depth = 0;
+
+		// The EventPackageHeader::invoke of the packages this event queues.
+		static void _invoke(std::byte* event_package) noexcept;
+
+		// Same as _invoke, for the packages trigger folds parameters into.
+		static void _invokeCoalesced(std::byte* event_package) noexcept;
+
+		// nullptr unless the event coalesces.
+		EventReducer<ParameterTypes ...> _reducer = nullptr;
 
 	public:
+		using token_t = EventHandlerToken<ParameterTypes ...>;
+
 		Name _event_name;
 
-		class EventPackage : public EventPackageInterface
+		static_assert(
+			(std::is_trivially_copyable_v<ParameterTypes> && ...),
+			"Event parameters are copied into the event queue with memcpy and must be trivially copyable."
+		);
+
+		// Flat, so parameters smaller than a pointer fit in the padding after the header.
+		struct EventPackage
+		{
+			decltype(EventPackageHeader::invoke) invoke;
+			std::uint16_t size;
+			EventParameters<ParameterTypes ...> parameters;
+			Event<ParameterTypes ...>* event;
+		};
+
+		static_assert(EventPackageType<EventPackage>);
+
+	private:
+		// Guards _pending_package and the parameters of the package it points to, which the queue reads in
+		// _invokeCoalesced.
+		std::mutex _coalescing_mutex;
+		// The package waiting in the queue that triggers are folded into, nullptr once the queue gets to it.
+		EventPackage* _pending_package = nullptr;
+
+		// Hands the parameters of a package that is about to be dispatched to the queue's recorder, if it has one.
+		void _record(const EventParameters<ParameterTypes ...>& parameters) noexcept
 		{
-			Event<ParameterTypes ...>& _event;
-			std::tuple<ParameterTypes ...> _parameters;
-
-		public:
-			EventPackage(Event<ParameterTypes ...>& event, std::tuple<ParameterTypes ...> parameters) noexcept
-				: EventPackageInterface(sizeof(EventPackage))
-				, _event(event)
-				, _parameters(parameters)
-			{}
-
-			~EventPackage() noexcept final = default;
-			EventPackage(EventPackage&&) noexcept = default;
-			EventPackage(const EventPackage&) noexcept = default;
-			EventPackage& operator=(EventPackage&&) noexcept = default;
-			EventPackage& operator=(const EventPackage&) noexcept = default;
-
-			void operator()() noexcept override
+			if (auto recorder = _event_queue.getRecorder(); recorder)
 			{
-				std::apply<Event<ParameterTypes...>&, std::tuple<ParameterTypes ...>>
-					(_event, std::forward<std::tuple<ParameterTypes ...>>(_parameters));
+				const auto payload = std::as_bytes(std::span(&parameters, 1));
+
+				recorder->record(_event_name.hash, _event_queue.getTickTime(), payload);
 			}
-		};
+		}
+
+		[[nodiscard]] EventPackage _makePackage(ParameterTypes ... parameters) noexcept
+		{
+			return EventPackage{
+				&Event::_invoke,
+				static_cast<std::uint16_t>(sizeof(EventPackage)),
+				EventParameters<ParameterTypes ...>{parameters ...},
+				this
+			};
+		}
+
+	public:
 
 		explicit Event(EventQueue& event_manager, std::wstring name) noexcept
 			: _event_queue(event_manager)
 			, _event_name(name)
 		{}
 
+		// An event that coalesces: a trigger while the event still has a package waiting in the queue folds its
+		// parameters into that package with reducer, instead of queueing another. The package keeps its place in the
+		// queue. Only trigger coalesces, triggerAt and triggerAfterFrames queue a package each.
+		explicit Event(EventQueue& event_manager, std::wstring name, EventReducer<ParameterTypes ...> reducer) noexcept
+			: _event_queue(event_manager)
+			, _reducer(reducer)
+			, _event_name(name)
+		{}
+
+		// Packages in the queue point at the event, it must stay where it is.
 		~Event() noexcept = default;
-		Event(Event&&) noexcept = default;
-		Event(const Event&) noexcept = default;
-		Event& operator=(Event&&) noexcept = default;
-		Event& operator=(const Event&) noexcept = default;
+		Event(Event&&) = delete;
+		Event(const Event&) = delete;
+		Event& operator=(Event&&) = delete;
+		Event& operator=(const Event&) = delete;
 		Event& operator<=>(const Event&) const noexcept = default;
 
-		void registerEventHandler(EventHandler<ParameterTypes ...>* event_handler) noexcept
+		// Handlers registered during a dispatch are first called by the next one.
+		token_t registerEventHandler(EventHandler<ParameterTypes ...>* event_handler) noexcept
 		{
-			event_handlers.insert(event_handler);
+			return _event_handlers.insert(event_handler);
+		}
+
+		// Safe to call from a handler, including for the handler that is running. Returns false when the token was
+		// already deregistered.
+		bool deregisterEventHandler(token_t token) noexcept
+		{
+			if (_dispatch_depth == 0) return _event_handlers.erase(token);
+
+			auto event_handler = _event_handlers.get(token);
+
+			if (event_handler == nullptr || *event_handler == nullptr) return false;
+
+			*event_handler = nullptr;
+			_pending_removals.push_back(token);
+
+			return true;
 		}
 
-		void deregisterEventHandler(EventHandler<ParameterTypes ...>* event_handler) noexcept
+		[[nodiscard]] std::size_t getEventHandlerCount() const noexcept
 		{
-			event_handlers.remove(event_handler);
+			return _event_handlers.size() - _pending_removals.size();
 		}
 
 		void operator()([[maybe_unused]] ParameterTypes&& ... parameters) noexcept
 		{
-			for (auto& event_handler : event_handlers)
+			++_dispatch_depth;
+
+			const auto event_handler_count = _event_handlers.size();
+			for (auto index = std::size_t{0}; index < event_handler_count; ++index)
+			{
+				// Read through objects() every time, a handler that registers another one can grow the storage.
+				if (auto event_handler = _event_handlers.objects()[index]; event_handler)
+				{
+					(*event_handler)(parameters...);
+				}
+			}
+
+			if (--_dispatch_depth == 0 && !_pending_removals.empty())
 			{
-				(*event_handler)(parameters...);
+				for (const auto token : _pending_removals) _event_handlers.erase(token);
+
+				_pending_removals.clear();
 			}
 		}
 
+		// Safe to call from any number of threads at once.
 		[[nodiscard]] std::expected<void, std::error_condition> trigger(ParameterTypes ... parameters) noexcept
 		{
-			return _event_queue.push(
-				Event::EventPackage(
-					*this,
-					std::tuple<ParameterTypes...>(parameters...)
-				)
+			if (!_reducer) return _event_queue.push(_makePackage(parameters ...));
+
+			[[maybe_unused]] auto lock = std::scoped_lock(_coalescing_mutex);
+
+			if (_pending_package)
+			{
+				_reducer(_pending_package->parameters, EventParameters<ParameterTypes ...>{parameters ...});
+
+				return {};
+			}
+
+			auto event_package = _makePackage(parameters ...);
+			event_package.invoke = &Event::_invokeCoalesced;
+
+			// Under the mutex, so the queue can not get to the package before _pending_package points at it.
+			return _event_queue.pushInPlace(event_package).transform(
+				[this](EventPackage* queued_package) noexcept { _pending_package = queued_package; }
 			);
 		}
+
+		[[nodiscard]] bool isCoalescing() const noexcept { return _reducer != nullptr; }
+
+		// Handlers are called by the first EventQueue::processTriggeredEvents whose tick time has reached deadline.
+		[[nodiscard]] std::expected<void, std::error_condition> triggerAt(
+			std::chrono::steady_clock::time_point deadline, ParameterTypes ... parameters
+		) noexcept
+		{
+			return _event_queue.pushAt(_makePackage(parameters ...), deadline);
+		}
+
+		// Handlers are called frames calls to EventQueue::processTriggeredEvents from now.
+		[[nodiscard]] std::expected<void, std::error_condition> triggerAfterFrames(
+			std::uint32_t frames, ParameterTypes ... parameters
+		) noexcept
+		{
+			return _event_queue.pushAfterFrames(_makePackage(parameters ...), frames);
+		}
 	};
+
+	template<typename ... ParameterTypes>
+	void Event<ParameterTypes ...>::_invoke(std::byte* event_package) noexcept
+	{
+		auto& package = *reinterpret_cast<EventPackage*>(event_package);
+
+		package.event->_record(package.parameters);
+
+		applyEventParameters(*package.event, package.parameters);
+	}
+
+	template<typename ... ParameterTypes>
+	void Event<ParameterTypes ...>::_invokeCoalesced(std::byte* event_package) noexcept
+	{
+		auto& package = *reinterpret_cast<EventPackage*>(event_package);
+		auto& event = *package.event;
+
+		// Copied out under the mutex and dispatched outside it, a handler may trigger the event again.
+		auto parameters = [&event, &package]() noexcept {
+			[[maybe_unused]] auto lock = std::scoped_lock(event._coalescing_mutex);
+
+			event._pending_package = nullptr;
+
+			return package.parameters;
+		}();
+
+		event._record(parameters);
+
+		applyEventParameters(event, parameters);
+	}
 }
@@ -4,39 +4,280 @@ import std;
 
 export import Error;
 export import EventQueue;
+export import EventRecorder;
 export import Name;
 
+import Windows;
+
+using namespace ::windows;
 using namespace mt::utility;
 using namespace mt::error;
 
-namespace mt::event
+export namespace mt::event
 {
+	// How EventManagerInterface::processEvents drains its queues.
+	enum class EventDispatchMode : std::uint8_t
+	{
+		// One queue after another on the calling thread.
+		SERIAL,
+		// Queues are drained at the same time, on the calling thread and a pool of workers.
+		PARALLEL
+	};
+
+	// Which thread drains a queue. ANY_THREAD and CALLING_THREAD only differ when the dispatch mode is PARALLEL.
+	// Either way a queue is drained by one thread at a time, so its handlers never run concurrently with each other.
+	enum class EventQueueAffinity : std::uint8_t
+	{
+		// Whichever thread gets to it first, worker or calling thread.
+		ANY_THREAD,
+		// Always the thread that calls processEvents, the tick thread. For handlers that touch thread affine state,
+		// such as the renderer's.
+		CALLING_THREAD,
+		// A consumer thread of the queue's own, see EventQueue::bindConsumerThread and EventQueue::runConsumer.
+		// processEvents never drains it.
+		CONSUMER_THREAD
+	};
+
+	// Owns the engine's named event queues and drains them once a frame, and reports their statistics.
+	//
+	// In PARALLEL mode the workers are started once there are two ANY_THREAD queues to share, until then there is
+	// nothing for them to do. They sleep on an atomic until processEvents hands them a frame. Calling thread and
+	// workers then claim ANY_THREAD queues one at a time from a shared index, the calling thread starts with the
+	// CALLING_THREAD queues. processEvents returns once every queue has been drained, it is the barrier between the
+	// events of a frame and whatever the tick function does next.
 	class EventManagerInterface
 	{
-		std::map<Name, std::unique_ptr<mt::event::EventQueue>> eventQueues{};
+		static constexpr std::size_t _CACHE_LINE = std::hardware_destructive_interference_size;
+
+		struct EventQueueEntry
+		{
+			std::unique_ptr<EventQueue> event_queue;
+			EventQueueAffinity affinity;
+		};
+
+		EventDispatchMode _dispatch_mode;
+		std::size_t _worker_count;
+
+		std::pmr::map<Name, EventQueueEntry> _event_queues;
+		std::pmr::vector<EventQueue*> _any_thread_queues;
+		std::pmr::vector<EventQueue*> _calling_thread_queues;
+
+		EventRecorder* _recorder = nullptr;
+
+		// Handed to the workers along with the frame.
+		std::chrono::steady_clock::time_point _tick_time{};
+
+		// Bumped once a frame to wake the workers, and once more to stop them.
+		alignas(_CACHE_LINE) std::atomic<std::uint64_t> _frame = 0;
+		// Index of the next ANY_THREAD queue to claim.
+		alignas(_CACHE_LINE) std::atomic<std::size_t> _next_queue = 0;
+		// Workers that have not finished the frame yet.
+		alignas(_CACHE_LINE) std::atomic<std::size_t> _busy_workers = 0;
+
+		std::pmr::vector<std::jthread> _workers;
+
+		void _drainAnyThreadQueues() noexcept
+		{
+			for (auto index = _next_queue.fetch_add(1, std::memory_order_relaxed);
+				index < _any_thread_queues.size();
+				index = _next_queue.fetch_add(1, std::memory_order_relaxed)
+			)
+			{
+				_any_thread_queues[index]->processTriggeredEvents(_tick_time);
+			}
+		}
+
+		// frame is the last frame handed out before the worker was started.
+		void _work(std::stop_token stop_token, std::uint64_t frame) noexcept
+		{
+			if (SetThreadDescription(GetCurrentThread(), L"mt::Engine Event Worker") < 0)
+				OutputDebugString(L"failed to set event worker thread name.");
+
+			while (true)
+			{
+				_frame.wait(frame, std::memory_order_acquire);
+
+				if (stop_token.stop_requested()) return;
+
+				frame = _frame.load(std::memory_order_acquire);
+
+				_drainAnyThreadQueues();
+
+				if (_busy_workers.fetch_sub(1, std::memory_order_release) == 1) _busy_workers.notify_one();
+			}
+		}
+
+		// Falls back to SERIAL when a worker can not be started.
+		void _startWorkers() noexcept
+		{
+			// Read before any worker runs. A worker that read it for itself could see the frame processEvents hands
+			// out next, and sleep through it.
+			const auto frame = _frame.load(std::memory_order_relaxed);
+
+			try
+			{
+				_workers.reserve(_worker_count);
+
+				for (auto i = std::size_t{0}; i < _worker_count; ++i)
+				{
+					_workers.emplace_back([this, frame](std::stop_token stop_token) noexcept {
+						_work(stop_token, frame);
+					});
+				}
+			}
+			catch (...)
+			{
+				_stopWorkers();
+				_dispatch_mode = EventDispatchMode::SERIAL;
+			}
+		}
+
+		void _stopWorkers() noexcept
+		{
+			for (auto& worker : _workers) worker.request_stop();
+
+			_frame.fetch_add(1, std::memory_order_release);
+			_frame.notify_all();
 
-		EventManagerInterface() noexcept = default;
-		EventManagerInterface(const EventManagerInterface&) noexcept = default;
-		EventManagerInterface(EventManagerInterface&&) noexcept = default;
-		EventManagerInterface& operator=(const EventManagerInterface&) noexcept = default;
-		EventManagerInterface& operator=(EventManagerInterface&&) noexcept = default;
-		auto operator<=>(const EventManagerInterface&) const noexcept = default;
+			_workers.clear();
+		}
+
+	public:
+		// PARALLEL uses worker_count workers, by default one less than there are hardware threads since the calling
+		// thread drains queues too. They are started along with the second ANY_THREAD queue, the manager falls back
+		// to SERIAL when one can not be started.
+		explicit EventManagerInterface(
+			[[maybe_unused]] std::error_condition& error,
+			EventDispatchMode dispatch_mode = EventDispatchMode::SERIAL,
+			std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource(),
+			std::size_t worker_count = std::max(std::thread::hardware_concurrency(), 1u) - 1
+		) noexcept
+			: _dispatch_mode(dispatch_mode)
+			, _worker_count(dispatch_mode == EventDispatchMode::PARALLEL ? worker_count : 0)
+			, _event_queues(memory_resource)
+			, _any_thread_queues(memory_resource)
+			, _calling_thread_queues(memory_resource)
+			, _workers(memory_resource)
+		{}
+
+		~EventManagerInterface() noexcept
+		{
+			_stopWorkers();
+		}
 
+		EventManagerInterface(const EventManagerInterface&) = delete;
+		EventManagerInterface(EventManagerInterface&&) = delete;
+		EventManagerInterface& operator=(const EventManagerInterface&) = delete;
+		EventManagerInterface& operator=(EventManagerInterface&&) = delete;
+
+		// Not while processEvents is running. Engine queues grow rather than drop events by default.
 		[[nodiscard]] std::expected<mt::event::EventQueue*, std::error_condition> createEventQueue(
-			Name name, std::size_t size
+			Name name,
+			std::size_t size,
+			EventQueueMode mode = EventQueueMode::MUTEX,
+			EventQueueAffinity affinity = EventQueueAffinity::ANY_THREAD,
+			EventQueueOverflow overflow = EventQueueOverflow::GROW
 		)
 		{
-			auto pair = eventQueues.try_emplace(name, std::make_unique<EventQueue>(size));
-			if (pair.second)
-				return pair.first->second.get();
-			else
+			auto pair = _event_queues.try_emplace(name, std::make_unique<EventQueue>(size, mode, overflow), affinity);
+			if (!pair.second)
 				return std::unexpected{MakeErrorCondition(ErrorCode::EVENT_QUEUE_ALREADY_EXISTS)};
+
+			auto event_queue = pair.first->second.event_queue.get();
+			event_queue->setRecorder(_recorder);
+
+			if (affinity == EventQueueAffinity::CALLING_THREAD)
+				_calling_thread_queues.push_back(event_queue);
+			else if (affinity == EventQueueAffinity::ANY_THREAD)
+				_any_thread_queues.push_back(event_queue);
+
+			if (_dispatch_mode == EventDispatchMode::PARALLEL && _workers.empty() && _any_thread_queues.size() == 2)
+				_startWorkers();
+
+			return event_queue;
 		}
 
+		// Fails with EVENT_QUEUE_NOT_FOUND when there is no queue called name.
 		[[nodiscard]] std::expected<mt::event::EventQueue*, std::error_condition> getEventQueue(Name name)
 		{
-			return eventQueues.find(name)->second.get();
+			auto found = _event_queues.find(name);
+			if (found == _event_queues.end())
+				return std::unexpected{MakeErrorCondition(ErrorCode::EVENT_QUEUE_NOT_FOUND)};
+
+			return found->second.event_queue.get();
+		}
+
+		// Records what every queue dispatches, including queues created later, nullptr stops recording. Not while
+		// processEvents is running.
+		void setRecorder(EventRecorder* recorder) noexcept
+		{
+			_recorder = recorder;
+
+			for (auto& [name, entry] : _event_queues) entry.event_queue->setRecorder(recorder);
+		}
+
+		// See EventQueue::getStatistics. Fails with EVENT_QUEUE_NOT_FOUND when there is no queue called name.
+		[[nodiscard]] std::expected<EventQueueStatistics, std::error_condition> getEventQueueStatistics(
+			Name name
+		) const noexcept
+		{
+			auto found = _event_queues.find(name);
+			if (found == _event_queues.end())
+				return std::unexpected{MakeErrorCondition(ErrorCode::EVENT_QUEUE_NOT_FOUND)};
+
+			return found->second.event_queue->getStatistics();
 		}
-	};
 
+		// Calls function(Name, const EventQueueStatistics&) for every queue, in name order. Meant for debug overlays
+		// and logging once a frame, between calls to processEvents.
+		template<typename Function>
+		void forEachEventQueueStatistics(Function&& function) const
+		{
+			for (const auto& [name, entry] : _event_queues)
+			{
+				function(name, entry.event_queue->getStatistics());
+			}
+		}
+
+		[[nodiscard]] EventDispatchMode getDispatchMode() const noexcept { return _dispatch_mode; }
+
+		// Workers that have been started, none before there are two ANY_THREAD queues.
+		[[nodiscard]] std::size_t getWorkerCount() const noexcept { return _workers.size(); }
+
+		// Drains every queue but the CONSUMER_THREAD ones with EventQueue::processTriggeredEvents(tick_time) and
+		// returns once they are all done. Events triggered while a queue is drained wait for the next call. Only ever
+		// call it from one thread.
+		void processEvents(std::chrono::steady_clock::time_point tick_time) noexcept
+		{
+			// Waking the workers costs more than they could save with fewer than two queues to share.
+			if (_dispatch_mode == EventDispatchMode::SERIAL || _workers.empty() || _any_thread_queues.size() < 2)
+			{
+				for (auto event_queue : _calling_thread_queues) event_queue->processTriggeredEvents(tick_time);
+				for (auto event_queue : _any_thread_queues) event_queue->processTriggeredEvents(tick_time);
+
+				return;
+			}
+
+			_tick_time = tick_time;
+			_next_queue.store(0, std::memory_order_relaxed);
+			_busy_workers.store(_workers.size(), std::memory_order_relaxed);
+
+			// Publishes the stores above to the workers.
+			_frame.fetch_add(1, std::memory_order_release);
+			_frame.notify_all();
+
+			for (auto event_queue : _calling_thread_queues) event_queue->processTriggeredEvents(tick_time);
+
+			_drainAnyThreadQueues();
+
+			// Acquire, so whatever the handlers did on the workers is visible once this returns.
+			for (auto busy_workers = _busy_workers.load(std::memory_order_acquire);
+				busy_workers != 0;
+				busy_workers = _busy_workers.load(std::memory_order_acquire)
+			)
+			{
+				_busy_workers.wait(busy_workers, std::memory_order_acquire);
+			}
+		}
+	};
 }
@@ -0,0 +1,98 @@
+module;
+
+// offsetof is a macro, import std does not provide it.
+#include <cstddef>
+
+export module EventPackageHeader;
+
+import std;
+
+export namespace mt::event
+{
+	// The start of every package in an EventQueue. The queue reads the header without knowing the package's type,
+	// calls invoke with the address of the package and then skips size bytes to the next one.
+	struct EventPackageHeader
+	{
+		void (*invoke)(std::byte* event_package) noexcept;
+		std::uint16_t size;
+	};
+
+	// A package is copied into the queue with memcpy, so it has to be trivially copyable, and it has to start with the
+	// members of EventPackageHeader so the queue can read them in place.
+	template<typename Package>
+	concept EventPackageType =
+		std::is_trivially_copyable_v<Package>
+		&& std::is_standard_layout_v<Package>
+		&& sizeof(Package) <= std::numeric_limits<std::uint16_t>::max()
+		&& requires(Package package)
+		{
+			{ package.invoke } -> std::same_as<decltype(EventPackageHeader::invoke)&>;
+			{ package.size } -> std::same_as<std::uint16_t&>;
+		}
+		&& offsetof(Package, invoke) == offsetof(EventPackageHeader, invoke)
+		&& offsetof(Package, size) == offsetof(EventPackageHeader, size);
+
+	// A trivially copyable stand in for std::tuple, whose assignment operators are user provided. Members are laid out
+	// in order with no trailing empty member, so small parameters pack into the padding after the header.
+	template<typename ... ParameterTypes>
+	struct EventParameters
+	{};
+
+	template<typename Last>
+	struct EventParameters<Last>
+	{
+		Last first;
+	};
+
+	template<typename First, typename ... Rest>
+	struct EventParameters<First, Rest ...>
+	{
+		First first;
+		EventParameters<Rest ...> rest;
+	};
+
+	// Calls function with the parameters moved out of event_parameters, in order.
+	template<typename Function, typename ... Bound>
+	void applyEventParameters(Function& function, EventParameters<>&, Bound& ... bound) noexcept
+	{
+		function(std::move(bound) ...);
+	}
+
+	template<typename Function, typename Last, typename ... Bound>
+	void applyEventParameters(Function& function, EventParameters<Last>& event_parameters, Bound& ... bound) noexcept
+	{
+		function(std::move(bound) ..., std::move(event_parameters.first));
+	}
+
+	template<typename Function, typename First, typename Second, typename ... Rest, typename ... Bound>
+	void applyEventParameters(
+		Function& function, EventParameters<First, Second, Rest ...>& event_parameters, Bound& ... bound
+	) noexcept
+	{
+		applyEventParameters(function, event_parameters.rest, bound ..., event_parameters.first);
+	}
+
+	// Calls function(pending_parameter, next_parameter) for each pair of parameters, in order.
+	template<typename Function>
+	void forEachEventParameter(Function&, EventParameters<>&, const EventParameters<>&) noexcept
+	{}
+
+	template<typename Function, typename Last>
+	void forEachEventParameter(
+		Function& function, EventParameters<Last>& pending, const EventParameters<Last>& next
+	) noexcept
+	{
+		function(pending.first, next.first);
+	}
+
+	template<typename Function, typename First, typename Second, typename ... Rest>
+	void forEachEventParameter(
+		Function& function,
+		EventParameters<First, Second, Rest ...>& pending,
+		const EventParameters<First, Second, Rest ...>& next
+	) noexcept
+	{
+		function(pending.first, next.first);
+		forEachEventParameter(function, pending.rest, next.rest);
+	}
+}
@@ -0,0 +1,244 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module EventPlayer;
+
+import std;
+
+import Error;
+import Event;
+import EventPackageHeader;
+import EventRecorder;
+import Windows;
+
+using namespace mt::error;
+using namespace windows;
+
+export namespace mt::event
+{
+	// Triggers the events of a log made by EventRecorder again, on the Events they were recorded from.
+	//
+	// Records are matched to events by name, every Event to play back has to be added with addEvent under the name it
+	// was recorded with. Records of events that were not added, or whose parameters have changed size since, are
+	// skipped and counted. The log is mapped into memory read only and never copied.
+	//
+	// playUntil follows the recorded tick times, at the original pace or faster. playNextTick triggers all the events
+	// of the next recorded tick at once, for replaying a session headless as fast as it will go. Either way the events
+	// are triggered, their handlers are called when their queue is next processed, so a frame's events reach the
+	// handlers in one frame, as they did when they were recorded.
+	class EventPlayer
+	{
+		using trigger_t = std::expected<void, std::error_condition> (*)(void* event, const std::byte* payload) noexcept;
+
+		struct EventTarget
+		{
+			void* event;
+			std::size_t payload_size;
+			trigger_t trigger;
+		};
+
+		HANDLE _file = INVALID_HANDLE_VALUE;
+		HANDLE _mapping = nullptr;
+		const std::byte* _log = nullptr;
+		std::size_t _log_size = 0;
+		// Offset of the next record to play.
+		std::size_t _cursor = sizeof(EventLogHeader);
+		// Tick time of the last record played, records never go back in time.
+		std::int64_t _previous_tick_time = std::numeric_limits<std::int64_t>::min();
+
+		std::pmr::unordered_map<std::uint64_t, EventTarget> _events;
+		std::size_t _skipped_count = 0;
+
+		std::int64_t _first_tick_time = 0;
+		std::chrono::steady_clock::time_point _playback_start{};
+		double _speed = 1.0;
+
+		template<typename ... ParameterTypes>
+		static std::expected<void, std::error_condition> _trigger(void* event, const std::byte* payload) noexcept
+		{
+			using Parameters = EventParameters<ParameterTypes ...>;
+
+			std::array<std::byte, sizeof(Parameters)> bytes;
+			std::memcpy(bytes.data(), payload, sizeof(Parameters));
+
+			auto parameters = std::bit_cast<Parameters>(bytes);
+
+			std::expected<void, std::error_condition> expected{};
+			auto trigger = [event, &expected](ParameterTypes ... values) noexcept {
+				expected = static_cast<Event<ParameterTypes ...>*>(event)->trigger(values ...);
+			};
+
+			applyEventParameters(trigger, parameters);
+
+			return expected;
+		}
+
+		// The header of the record at the cursor, nothing when the log has been played to the end.
+		[[nodiscard]] std::optional<EventRecordHeader> _peek() const noexcept
+		{
+			if (_log_size - _cursor < EVENT_RECORD_HEADER_SIZE) return std::nullopt;
+
+			auto header = readEventRecordHeader(_log + _cursor);
+
+			// A recorder that was never destroyed leaves the file grown ahead of the log and zero filled, and may have
+			// written only part of its last record. Zeroes, a tick earlier than the one before or a record that does
+			// not fit in the file end the log.
+			if (header.name_hash == 0 && header.payload_size == 0) return std::nullopt;
+			if (header.tick_time < _previous_tick_time) return std::nullopt;
+			if (_log_size - _cursor - EVENT_RECORD_HEADER_SIZE < header.payload_size) return std::nullopt;
+
+			return header;
+		}
+
+		// Triggers records up to and including tick_time. Stops at a record whose trigger fails, it is tried again
+		// by the next call.
+		[[nodiscard]] std::expected<std::size_t, std::error_condition> _play(std::int64_t tick_time) noexcept
+		{
+			std::size_t played_count = 0;
+
+			for (auto header = _peek(); header && header->tick_time <= tick_time; header = _peek())
+			{
+				auto found = _events.find(header->name_hash);
+
+				if (found != _events.end() && found->second.payload_size == header->payload_size)
+				{
+					const auto& target = found->second;
+
+					auto expected = target.trigger(target.event, _log + _cursor + EVENT_RECORD_HEADER_SIZE);
+
+					if (!expected) return std::unexpected(expected.error());
+
+					++played_count;
+				}
+				else
+				{
+					++_skipped_count;
+				}
+
+				_cursor += EVENT_RECORD_HEADER_SIZE + header->payload_size;
+				_previous_tick_time = header->tick_time;
+			}
+
+			return played_count;
+		}
+
+		void _close() noexcept
+		{
+			if (_log) UnmapViewOfFile(_log);
+			if (_mapping) CloseHandle(_mapping);
+			if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+
+			_log = nullptr;
+			_log_size = 0;
+			_mapping = nullptr;
+			_file = INVALID_HANDLE_VALUE;
+		}
+
+	public:
+		EventPlayer(
+			const std::filesystem::path& path,
+			std::error_condition& error,
+			std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource()
+		) noexcept
+			: _events(memory_resource)
+		{
+			_file = CreateFileW(
+				path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+			);
+
+			LARGE_INTEGER file_size{};
+
+			if (_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &file_size))
+			{
+				_close();
+				Assign(error, ErrorCode::EVENT_LOG_OPEN_FAILED);
+				return;
+			}
+
+			if (static_cast<std::uint64_t>(file_size.QuadPart) < sizeof(EventLogHeader))
+			{
+				_close();
+				Assign(error, ErrorCode::EVENT_LOG_INVALID);
+				return;
+			}
+
+			_mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			_log = _mapping ? static_cast<const std::byte*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+			if (!_log)
+			{
+				_close();
+				Assign(error, ErrorCode::EVENT_LOG_OPEN_FAILED);
+				return;
+			}
+
+			_log_size = static_cast<std::size_t>(file_size.QuadPart);
+
+			EventLogHeader log_header;
+			std::memcpy(&log_header, _log, sizeof(log_header));
+
+			if (log_header.magic != EVENT_LOG_MAGIC || log_header.version != EVENT_LOG_VERSION)
+			{
+				_close();
+				Assign(error, ErrorCode::EVENT_LOG_INVALID);
+				return;
+			}
+
+			if (auto header = _peek(); header) _first_tick_time = header->tick_time;
+		}
+
+		~EventPlayer() noexcept
+		{
+			_close();
+		}
+
+		EventPlayer(const EventPlayer&) = delete;
+		EventPlayer(EventPlayer&&) = delete;
+		EventPlayer& operator=(const EventPlayer&) = delete;
+		EventPlayer& operator=(EventPlayer&&) = delete;
+
+		// Records with the event's name are triggered on it. The event must outlive the player.
+		template<typename ... ParameterTypes>
+		void addEvent(Event<ParameterTypes ...>& event)
+		{
+			_events.insert_or_assign(
+				event._event_name.hash,
+				EventTarget{
+					&event, sizeof(EventParameters<ParameterTypes ...>), &EventPlayer::_trigger<ParameterTypes ...>
+				}
+			);
+		}
+
+		// The first recorded tick plays at playback_start, later ones speed times closer together than they were
+		// recorded.
+		void start(std::chrono::steady_clock::time_point playback_start, double speed = 1.0) noexcept
+		{
+			_playback_start = playback_start;
+			_speed = speed;
+		}
+
+		// Triggers every record whose tick time, moved to playback time, is at or before tick_time. Returns how many
+		// events were triggered.
+		[[nodiscard]] std::expected<std::size_t, std::error_condition> playUntil(
+			std::chrono::steady_clock::time_point tick_time
+		) noexcept
+		{
+			const auto elapsed = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double, std::chrono::steady_clock::period>(tick_time - _playback_start) * _speed
+			);
+
+			return _play(_first_tick_time + elapsed.count());
+		}
+
+		// Triggers every record of the next recorded tick, whenever it was. Returns how many events were triggered.
+		[[nodiscard]] std::expected<std::size_t, std::error_condition> playNextTick() noexcept
+		{
+			if (auto header = _peek(); header) return _play(header->tick_time);
+
+			return 0;
+		}
+
+		[[nodiscard]] bool isFinished() const noexcept { return !_peek(); }
+
+		// Records that did not match an added event.
+		[[nodiscard]] std::size_t getSkippedCount() const noexcept { return _skipped_count; }
+	};
+}
@@ -2,134 +2,890 @@ export module EventQueue;
 
 import std.compat;
 
-import EventPackageInterface;
+import BackingStore;
+import Constants;
+import EventPackageHeader;
+import EventRecorder;
+import RingAllocator;
+import ThreadingPolicy;
 
 export namespace mt::event
 {
+	// How producers share an EventQueue. Either way there is a single consumer, the thread that processes events.
+	enum class EventQueueMode : std::uint8_t
+	{
+		// Producers take a mutex to reserve space, packages are stored back to back.
+		MUTEX,
+		// Producers reserve with a compare and swap and never wait on each other, every package is preceded by a
+		// commit stamp. For queues that many threads trigger events on.
+		LOCK_FREE
+	};
+
+	// What push does when the ring is full.
+	enum class EventQueueOverflow : std::uint8_t
+	{
+		// Fails with errc::not_enough_memory.
+		REJECT,
+		// Chains overflow segments behind the ring until the burst has been processed.
+		GROW
+	};
+
+	// Counters an EventQueue keeps about its pushes and how long their packages wait, see EventQueue::getStatistics.
+	// All zero when statistics are compiled out.
+	struct EventQueueStatistics
+	{
+		// Packages pushed to the ring or the overflow chain since the queue was created, and their bytes. Packages
+		// pushed to the delayed lane are not counted.
+		std::uint64_t pushes;
+		std::uint64_t pushed_bytes;
+		// Pushes between the last two calls to processTriggeredEvents.
+		std::uint64_t pushes_per_frame;
+		std::uint64_t pushed_bytes_per_frame;
+		// Most bytes the ring and overflow segments held at once, sampled when processTriggeredEvents starts.
+		std::size_t used_space_high_water;
+		// Times the ring's write position went back to the start of the buffer.
+		std::uint64_t wraparounds;
+		// Packages the last call to processTriggeredEvents dispatched from the ring and the overflow chain, and how
+		// long they waited between being pushed and that call.
+		std::uint64_t dispatches_per_frame;
+		std::chrono::nanoseconds mean_latency_per_frame;
+		std::chrono::nanoseconds max_latency_per_frame;
+		std::chrono::nanoseconds max_latency;
+	};
+
+	// Event packages live in a RingAllocator until the tick thread processes them. The ring is carved out of a
+	// BackingStore picked when the queue is constructed, see BackingStore.ixx.
+	//
+	// With EventQueueOverflow::GROW a push that does not fit in the ring goes to a chain of overflow segments instead,
+	// and so does every push after it until the consumer has emptied the chain, which keeps packages in order. The
+	// overflow path takes a mutex, the ring fast path only pays for one load of a flag that is almost always false.
+	// Emptied segments go back to a small pool and the rest are freed, so the queue shrinks back once the burst passes.
+	//
+	// Packages pushed with pushAt or pushAfterFrames wait in a delayed lane instead, a pair of heaps ordered by
+	// deadline that hold the packages inline. The delayed lane takes a mutex, it is for the occasional delayed
+	// gameplay message rather than per frame traffic.
+	//
+	// Unless MT_NO_EVENT_QUEUE_STATISTICS is defined, every package in the ring and the overflow chain is preceded by
+	// the time it was pushed, and pushes are counted in relaxed atomics spread over a few cache lines so producers on
+	// different threads rarely add to the same one. processTriggeredEvents keeps the rest of EventQueueStatistics on a
+	// cache line of its own.
+	//
+	// A queue can be bound to a consumer thread of its own with bindConsumerThread, for consumers such as a render or
+	// loader thread that should block until there is work rather than poll. The consumer sleeps in waitForEvents on
+	// an atomic wait, a futex or WaitOnAddress, once it has found the queue empty. Only the first push after that
+	// wakes it with notify_one, every other push pays for a fence and the load of a flag that no one is writing.
+	// Delayed packages do not wake the consumer, they are processed by the first processTriggeredEvents that runs
+	// after their deadline.
 	class EventQueue
 	{
-		std::unique_ptr<std::byte, decltype(std::free)*> _data =
-			std::unique_ptr<std::byte, decltype(std::free)*>((std::byte*)nullptr, std::free);
-		const std::size_t _capacity;
-		std::byte * const _start{};
-		std::byte * const _end{};
-		std::byte * _front{};
-		std::byte * _back{};
-		std::byte * _rollover{};
-		std::mutex _back_lock{};
+	public:
+		// Largest package the delayed lane holds inline.
+		static constexpr std::size_t MAX_DELAYED_PACKAGE_SIZE = 64;
+		// Bytes stored in front of every package in the ring and the overflow chain, the time it was pushed when
+		// statistics are compiled in. Keeps the package at its alignment.
+		static constexpr std::size_t PACKAGE_OVERHEAD = mt::HAS_EVENT_QUEUE_STATISTICS ? alignof(std::max_align_t) : 0;
+
+	private:
+		using MutexRing = mt::memory::RingAllocator<mt::memory::MutexPolicy>;
+		using LockFreeRing = mt::memory::RingAllocator<mt::memory::LockFreePolicy>;
+
+		// Packages are read back without knowing their type, so they are all placed at the same alignment.
+		static constexpr std::size_t _PACKAGE_ALIGNMENT = alignof(std::max_align_t);
+
+		// Delayed packages reserved for up front, the heaps only allocate when more than this are waiting.
+		static constexpr std::size_t _DELAYED_EVENT_RESERVE = 64;
+
+		// Bytes of packages an overflow segment holds, enough for the largest package.
+		static constexpr std::size_t _OVERFLOW_SEGMENT_CAPACITY = std::size_t{1} << 16;
+		// Emptied segments kept for the next burst, the rest are freed.
+		static constexpr std::size_t _MAX_SPARE_SEGMENTS = 1;
+
+		// The start of every overflow segment, its packages follow. read is only used by the consumer, next and write
+		// are guarded by _overflow_mutex.
+		struct alignas(_PACKAGE_ALIGNMENT) OverflowSegment
+		{
+			OverflowSegment* next;
+			std::size_t read;
+			std::size_t write;
+		};
+
+		static constexpr std::size_t _CACHE_LINE = std::hardware_destructive_interference_size;
+		// Cache lines pushes are counted on, a producer always counts on the same one.
+		static constexpr std::size_t _PUSH_COUNTER_STRIPES = 8;
+
+		struct alignas(_CACHE_LINE) PushCounters
+		{
+			std::atomic<std::uint64_t> pushes = 0;
+			std::atomic<std::uint64_t> pushed_bytes = 0;
+		};
+
+		// Only written by processTriggeredEvents.
+		struct alignas(_CACHE_LINE) DispatchCounters
+		{
+			std::atomic<std::uint64_t> pushes_at_frame_start = 0;
+			std::atomic<std::uint64_t> pushed_bytes_at_frame_start = 0;
+			std::atomic<std::uint64_t> pushes_per_frame = 0;
+			std::atomic<std::uint64_t> pushed_bytes_per_frame = 0;
+			std::atomic<std::size_t> used_space_high_water = 0;
+			std::atomic<std::uint64_t> dispatches_per_frame = 0;
+			// In steady_clock ticks.
+			std::atomic<std::int64_t> latency_sum_per_frame = 0;
+			std::atomic<std::int64_t> max_latency_per_frame = 0;
+			std::atomic<std::int64_t> max_latency = 0;
+		};
+
+		struct Counters
+		{
+			std::array<PushCounters, _PUSH_COUNTER_STRIPES> push{};
+			DispatchCounters dispatch{};
+		};
+
+		// Latency of the packages dispatched by one call to processTriggeredEvents, in steady_clock ticks.
+		struct DispatchLatency
+		{
+			std::int64_t dispatch_time = 0;
+			std::uint64_t dispatches = 0;
+			std::int64_t sum = 0;
+			std::int64_t max = 0;
+
+			void add(const std::byte* stamp) noexcept
+			{
+				if constexpr (mt::HAS_EVENT_QUEUE_STATISTICS)
+				{
+					std::int64_t push_time;
+					std::memcpy(&push_time, stamp, sizeof(push_time));
+
+					const auto latency = std::max(dispatch_time - push_time, std::int64_t{0});
+
+					++dispatches;
+					sum += latency;
+					max = std::max(max, latency);
+				}
+			}
+		};
+
+		struct DelayedEvent
+		{
+			// A steady_clock tick count or a frame number, depending on the heap.
+			std::int64_t deadline;
+			// Orders packages with the same deadline by when they were pushed.
+			std::uint64_t sequence;
+			alignas(_PACKAGE_ALIGNMENT) std::array<std::byte, MAX_DELAYED_PACKAGE_SIZE> package;
+		};
+
+		std::error_condition _error{};
+		// Never std::monostate once constructed, the rings can not be moved into place.
+		std::variant<std::monostate, MutexRing, LockFreeRing> _ring{};
+
+		EventQueueOverflow _overflow;
+		// Set while the overflow chain holds packages, every push goes to the chain until it is cleared again.
+		alignas(std::hardware_destructive_interference_size) std::atomic<bool> _is_overflowing = false;
+		// Set by bindConsumerThread, producers only wake the consumer when it is.
+		std::atomic<bool> _has_consumer_thread = false;
+
+		std::mutex _overflow_mutex;
+		OverflowSegment* _overflow_head = nullptr;
+		OverflowSegment* _overflow_tail = nullptr;
+		std::size_t _overflow_segment_count = 0;
+		// Linked through next.
+		OverflowSegment* _spare_segments = nullptr;
+		std::size_t _spare_segment_count = 0;
+		// Overflow segments come from the ring's BackingStore.
+		void* (*_allocate_segment)(std::size_t bytes) noexcept = nullptr;
+		void (*_deallocate_segment)(void* data) noexcept = nullptr;
+
+		std::mutex _delayed_mutex;
+		std::pmr::vector<DelayedEvent> _delayed_by_time;
+		std::pmr::vector<DelayedEvent> _delayed_by_frame;
+		std::uint64_t _delayed_sequence = 0;
+
+		std::thread::id _consumer_thread{};
+		// 1 once the consumer has found the queue empty and may be asleep on it, the first push after that sets it
+		// back to 0 and wakes the consumer. 32 bits, the size futexes and WaitOnAddress wait on natively.
+		alignas(std::hardware_destructive_interference_size) std::atomic<std::uint32_t> _is_consumer_idle = 0;
+		// Set by wakeConsumer.
+		std::atomic<bool> _is_wake_requested = false;
+
+		// Number of calls to processTriggeredEvents, the clock pushAfterFrames counts in.
+		std::atomic<std::uint64_t> _frame = 0;
+
+		// Only used by processTriggeredEvents, due packages are dispatched from here outside the mutex.
+		std::pmr::vector<DelayedEvent> _due_events;
+
+		// Left at zero when statistics are compiled out.
+		Counters _counters{};
+
+		// Set by processTriggeredEvents for the packages it dispatches.
+		std::chrono::steady_clock::time_point _tick_time{};
+		EventRecorder* _recorder = nullptr;
+
+		// Makes the earliest deadline the top of the heap.
+		[[nodiscard]] static bool _isLater(const DelayedEvent& left, const DelayedEvent& right) noexcept
+		{
+			return left.deadline != right.deadline ? left.deadline > right.deadline : left.sequence > right.sequence;
+		}
+
+		template<EventPackageType Package>
+		[[nodiscard]] std::expected<void, std::error_condition> _pushDelayed(
+			std::pmr::vector<DelayedEvent>& delayed_events, std::int64_t deadline, const Package& event_package
+		) noexcept
+		{
+			static_assert(sizeof(Package) <= MAX_DELAYED_PACKAGE_SIZE && alignof(Package) <= _PACKAGE_ALIGNMENT);
+
+			[[maybe_unused]] auto lock = std::scoped_lock(_delayed_mutex);
+
+			try
+			{
+				auto& delayed_event = delayed_events.emplace_back(DelayedEvent{deadline, _delayed_sequence++, {}});
+				std::memcpy(delayed_event.package.data(), &event_package, sizeof(Package));
+			}
+			catch (...)
+			{
+				return std::unexpected(std::make_error_condition(std::errc::not_enough_memory));
+			}
+
+			std::ranges::push_heap(delayed_events, _isLater);
+
+			return {};
+		}
+
+		// Due events that do not fit in _due_events stay in the heap for the next call.
+		void _takeDueEvents(std::pmr::vector<DelayedEvent>& delayed_events, std::int64_t deadline) noexcept
+		{
+			while (!delayed_events.empty() && delayed_events.front().deadline <= deadline)
+			{
+				try
+				{
+					_due_events.push_back(delayed_events.front());
+				}
+				catch (...)
+				{
+					return;
+				}
+
+				std::ranges::pop_heap(delayed_events, _isLater);
+				delayed_events.pop_back();
+			}
+		}
+
+		[[nodiscard]] static std::byte* _getSegmentData(OverflowSegment* segment) noexcept
+		{
+			return reinterpret_cast<std::byte*>(segment + 1);
+		}
+
+		[[nodiscard]] static constexpr std::size_t _getOverflowSize(std::size_t package_size) noexcept
+		{
+			return (package_size + _PACKAGE_ALIGNMENT - 1) / _PACKAGE_ALIGNMENT * _PACKAGE_ALIGNMENT;
+		}
+
+		// _overflow_mutex must be held.
+		[[nodiscard]] OverflowSegment* _takeSegment() noexcept
+		{
+			auto segment = _spare_segments;
+
+			if (segment)
+			{
+				_spare_segments = segment->next;
+				--_spare_segment_count;
+			}
+			else
+			{
+				segment = static_cast<OverflowSegment*>(
+					_allocate_segment(sizeof(OverflowSegment) + _OVERFLOW_SEGMENT_CAPACITY)
+				);
+
+				if (!segment) return nullptr;
+			}
+
+			*segment = OverflowSegment{nullptr, 0, 0};
+			++_overflow_segment_count;
+
+			return segment;
+		}
+
+		// _overflow_mutex must be held.
+		void _recycleSegment(OverflowSegment* segment) noexcept
+		{
+			--_overflow_segment_count;
+
+			if (_spare_segment_count < _MAX_SPARE_SEGMENTS)
+			{
+				segment->next = _spare_segments;
+				_spare_segments = segment;
+				++_spare_segment_count;
+			}
+			else
+			{
+				_deallocate_segment(segment);
+			}
+		}
+
+		// Bytes of packages in the overflow chain that have not been processed, only the consumer may call it.
+		[[nodiscard]] std::size_t _getOverflowUsedSpace() noexcept
+		{
+			[[maybe_unused]] auto lock = std::scoped_lock(_overflow_mutex);
+
+			std::size_t used_space = 0;
+
+			for (auto segment = _overflow_head; segment; segment = segment->next)
+			{
+				used_space += segment->write - segment->read;
+			}
+
+			return used_space;
+		}
+
+		// Threads take the stripes in turn, the first _PUSH_COUNTER_STRIPES producers never share one.
+		[[nodiscard]] static std::size_t _getPushStripe() noexcept
+		{
+			static std::atomic<std::size_t> next_stripe = 0;
+			thread_local const std::size_t stripe =
+				next_stripe.fetch_add(1, std::memory_order_relaxed) % _PUSH_COUNTER_STRIPES;
+
+			return stripe;
+		}
+
+		static void _stamp(std::byte* stamp) noexcept
+		{
+			if constexpr (mt::HAS_EVENT_QUEUE_STATISTICS)
+			{
+				const auto push_time = std::chrono::steady_clock::now().time_since_epoch().count();
+				std::memcpy(stamp, &push_time, sizeof(push_time));
+			}
+		}
+
+		void _countPush(std::size_t bytes) noexcept
+		{
+			if constexpr (mt::HAS_EVENT_QUEUE_STATISTICS)
+			{
+				auto& counters = _counters.push[_getPushStripe()];
+
+				counters.pushes.fetch_add(1, std::memory_order_relaxed);
+				counters.pushed_bytes.fetch_add(bytes, std::memory_order_relaxed);
+			}
+		}
+
+		// Closes the frame that ends with this call to processTriggeredEvents.
+		void _countFrame() noexcept
+		{
+			if constexpr (mt::HAS_EVENT_QUEUE_STATISTICS)
+			{
+				std::uint64_t pushes = 0;
+				std::uint64_t pushed_bytes = 0;
+
+				for (const auto& counters : _counters.push)
+				{
+					pushes += counters.pushes.load(std::memory_order_relaxed);
+					pushed_bytes += counters.pushed_bytes.load(std::memory_order_relaxed);
+				}
+
+				auto& counters = _counters.dispatch;
+
+				const auto pushes_at_frame_start =
+					counters.pushes_at_frame_start.exchange(pushes, std::memory_order_relaxed);
+				const auto pushed_bytes_at_frame_start =
+					counters.pushed_bytes_at_frame_start.exchange(pushed_bytes, std::memory_order_relaxed);
+
+				counters.pushes_per_frame.store(pushes - pushes_at_frame_start, std::memory_order_relaxed);
+				counters.pushed_bytes_per_frame.store(
+					pushed_bytes - pushed_bytes_at_frame_start, std::memory_order_relaxed
+				);
+
+				// Nothing is released between calls, so the queue is at its fullest for the frame right now.
+				const auto used_space = getUsedSpace() + _getOverflowUsedSpace();
+
+				if (used_space > counters.used_space_high_water.load(std::memory_order_relaxed))
+					counters.used_space_high_water.store(used_space, std::memory_order_relaxed);
+			}
+		}
+
+		void _countDispatches(const DispatchLatency& latency) noexcept
+		{
+			if constexpr (mt::HAS_EVENT_QUEUE_STATISTICS)
+			{
+				auto& counters = _counters.dispatch;
+
+				counters.dispatches_per_frame.store(latency.dispatches, std::memory_order_relaxed);
+				counters.latency_sum_per_frame.store(latency.sum, std::memory_order_relaxed);
+				counters.max_latency_per_frame.store(latency.max, std::memory_order_relaxed);
+
+				if (latency.max > counters.max_latency.load(std::memory_order_relaxed))
+					counters.max_latency.store(latency.max, std::memory_order_relaxed);
+			}
+		}
+
+		// Called after every push to a queue with a consumer thread.
+		void _signalConsumer() noexcept
+		{
+			// Pairs with the fence in waitForEvents, either the consumer sees the package or this sees it is idle.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			// Every producer but the first after the queue went idle stops at the load.
+			if (_is_consumer_idle.load(std::memory_order_relaxed) != 0
+				&& _is_consumer_idle.exchange(0, std::memory_order_relaxed) != 0)
+			{
+				_is_consumer_idle.notify_one();
+			}
+		}
+
+		// Whether the ring or the overflow chain holds packages, including ones still being copied in.
+		[[nodiscard]] bool _hasQueuedEvents() const noexcept
+		{
+			if (isOverflowing()) return true;
+
+			return _visitRing(*this, [](const auto& ring) noexcept {
+				return ring.getReleaseCursor() != ring.getReserveCursor();
+			});
+		}
+
+		template<EventPackageType Package>
+		[[nodiscard]] std::expected<Package*, std::error_condition> _pushRing(const Package& event_package) noexcept
+		{
+			return _visitRing(*this, [&event_package](auto& ring) noexcept
+				-> std::expected<Package*, std::error_condition>
+			{
+				auto allocation = ring.allocate(PACKAGE_OVERHEAD + sizeof(Package), _PACKAGE_ALIGNMENT);
+
+				if (!allocation)
+				{
+					return std::unexpected(std::make_error_condition(std::errc::not_enough_memory));
+				}
+
+				auto package = allocation.data + PACKAGE_OVERHEAD;
+
+				_stamp(allocation.data);
+				::memcpy_s(package, sizeof(Package), &event_package, sizeof(Package));
+
+				ring.commit(allocation);
+
+				return reinterpret_cast<Package*>(package);
+			});
+		}
+
+		template<EventPackageType Package>
+		[[nodiscard]] std::expected<Package*, std::error_condition> _pushOverflow(const Package& event_package) noexcept
+		{
+			constexpr auto size = _getOverflowSize(PACKAGE_OVERHEAD + sizeof(Package));
+			static_assert(size <= _OVERFLOW_SEGMENT_CAPACITY, "The package does not fit in an overflow segment.");
+
+			[[maybe_unused]] auto lock = std::scoped_lock(_overflow_mutex);
+
+			// The consumer may have emptied the chain since the flag was read.
+			if (!_is_overflowing.load(std::memory_order_relaxed))
+			{
+				if (auto queued = _pushRing(event_package); queued) return queued;
+			}
+
+			if (!_overflow_tail || _OVERFLOW_SEGMENT_CAPACITY - _overflow_tail->write < size)
+			{
+				auto segment = _takeSegment();
+
+				if (!segment) return std::unexpected(std::make_error_condition(std::errc::not_enough_memory));
+
+				if (_overflow_tail)
+					_overflow_tail->next = segment;
+				else
+					_overflow_head = segment;
+
+				_overflow_tail = segment;
+			}
+
+			auto stamp = _getSegmentData(_overflow_tail) + _overflow_tail->write;
+			auto package = stamp + PACKAGE_OVERHEAD;
+
+			_stamp(stamp);
+			::memcpy_s(package, sizeof(Package), &event_package, sizeof(Package));
+			_overflow_tail->write += size;
+
+			_is_overflowing.store(true, std::memory_order_relaxed);
+
+			return reinterpret_cast<Package*>(package);
+		}
+
+		// Processes the overflow chain up to write in last_segment, where it ended when processing started.
+		void _processOverflow(OverflowSegment* last_segment, std::size_t last_write, DispatchLatency& latency) noexcept
+		{
+			auto segment = [this]() noexcept {
+				[[maybe_unused]] auto lock = std::scoped_lock(_overflow_mutex);
+				return _overflow_head;
+			}();
+
+			while (segment)
+			{
+				// Producers moved on from every segment before the last one, their write no longer changes.
+				const auto write = segment == last_segment ? last_write : segment->write;
+
+				while (segment->read < write)
+				{
+					auto stamp = _getSegmentData(segment) + segment->read;
+					auto package = stamp + PACKAGE_OVERHEAD;
+					const auto& header = *reinterpret_cast<const EventPackageHeader*>(package);
+
+					latency.add(stamp);
+					header.invoke(package);
+
+					segment->read += _getOverflowSize(PACKAGE_OVERHEAD + header.size);
+				}
+
+				if (segment == last_segment) break;
+
+				[[maybe_unused]] auto lock = std::scoped_lock(_overflow_mutex);
+
+				_overflow_head = segment->next;
+				_recycleSegment(std::exchange(segment, _overflow_head));
+			}
+
+			[[maybe_unused]] auto lock = std::scoped_lock(_overflow_mutex);
+
+			// The burst is over once the only segment left has been read to the end, pushes go to the ring again.
+			if (_overflow_head && _overflow_head == _overflow_tail && _overflow_head->read == _overflow_head->write)
+			{
+				_recycleSegment(_overflow_head);
+				_overflow_head = nullptr;
+				_overflow_tail = nullptr;
+
+				_is_overflowing.store(false, std::memory_order_relaxed);
+			}
+		}
+
+		template<typename Self, typename Function>
+		static decltype(auto) _visitRing(Self& self, Function&& function) noexcept
+		{
+			if (auto ring = std::get_if<LockFreeRing>(&self._ring)) return function(*ring);
+
+			return function(std::get<MutexRing>(self._ring));
+		}
 
 	public:
-		explicit EventQueue(std::size_t size_of_queue = 1024 * 5) noexcept
-			: _data(static_cast<std::byte*>(std::malloc(size_of_queue)), std::free)
-			, _capacity(size_of_queue)
-			, _start(_data.get())
-			, _end(_data.get() + size_of_queue + 1)
-			, _front(_data.get())
-			, _back(_data.get())
-			, _rollover(_data.get())
-		{}
-
-		~EventQueue() = default;
+		template<mt::memory::BackingStorePolicy BackingStore = mt::memory::MallocBackingStore>
+		explicit EventQueue(
+			std::size_t size_of_queue = 1024 * 5,
+			EventQueueMode mode = EventQueueMode::MUTEX,
+			EventQueueOverflow overflow = EventQueueOverflow::REJECT,
+			BackingStore backing_store = {}
+		) noexcept
+			: _overflow(overflow)
+			, _allocate_segment(&BackingStore::allocate)
+			, _deallocate_segment(&BackingStore::deallocate)
+		{
+			_delayed_by_time.reserve(_DELAYED_EVENT_RESERVE);
+			_delayed_by_frame.reserve(_DELAYED_EVENT_RESERVE);
+			_due_events.reserve(_DELAYED_EVENT_RESERVE);
+
+			if (mode == EventQueueMode::LOCK_FREE)
+				_ring.emplace<LockFreeRing>(size_of_queue, _error, backing_store);
+			else
+				_ring.emplace<MutexRing>(size_of_queue, _error, backing_store);
+		}
+
+		~EventQueue() noexcept
+		{
+			for (auto segment = _overflow_head; segment;) _deallocate_segment(std::exchange(segment, segment->next));
+			for (auto segment = _spare_segments; segment;) _deallocate_segment(std::exchange(segment, segment->next));
+		}
+
 		EventQueue(EventQueue&&) = delete;
 		EventQueue(const EventQueue&) = delete;
 		EventQueue& operator=(EventQueue&&) = delete;
 		EventQueue& operator=(const EventQueue&) = delete;
 
-		template<typename EventPackageType> requires std::derived_from<EventPackageType, EventPackageInterface>
-		[[nodiscard]] std::expected<void, std::error_condition> push(EventPackageType&& event_package)
+		// Safe to call from any number of threads at once.
+		template<EventPackageType Package>
+		[[nodiscard]] std::expected<void, std::error_condition> push(const Package& event_package)
 		{
-			[[maybe_unused]] auto lock = std::lock_guard(_back_lock);
+			return pushInPlace(event_package).transform([](Package*) noexcept {});
+		}
+
+		// Same as push, but returns the package's copy in the queue. It stays where it is until its invoke has been
+		// called, until then the caller may update everything but the header, as long as invoke synchronizes with it.
+		template<EventPackageType Package>
+		[[nodiscard]] std::expected<Package*, std::error_condition> pushInPlace(const Package& event_package)
+		{
+			static_assert(alignof(Package) <= _PACKAGE_ALIGNMENT);
+
+			auto queued = [this, &event_package]() noexcept -> std::expected<Package*, std::error_condition> {
+				// A producer always sees the flag its own pushes set. Whether it sees another thread's does not
+				// matter, their pushes are not ordered with its own.
+				if (!_is_overflowing.load(std::memory_order_relaxed))
+				{
+					if (auto in_ring = _pushRing(event_package); in_ring || _overflow == EventQueueOverflow::REJECT)
+					{
+						return in_ring;
+					}
+				}
 
-			void* aligned = reinterpret_cast<void*>(_back);
+				return _pushOverflow(event_package);
+			}();
 
-			std::size_t space = (_end - _back) - std::size_t{1};
-			// Do we fit at the back?
-			if (auto expected = std::align(alignof(EventPackageType), sizeof(EventPackageType), aligned, space);
-				expected == nullptr
-				)
+			if (queued)
 			{
-				aligned = const_cast<void*>(reinterpret_cast<const void*>(_start));
-				// b
-				// ------f/b---------E
-				// ------FxxxxB------E
-				// xxxxxxB----FxxxxxxE
-				if (_front < _back)
-					space = _front - _start;
-				else
-					space = _back - _start;
+				_countPush(sizeof(Package));
+
+				if (_has_consumer_thread.load(std::memory_order_relaxed)) _signalConsumer();
+			}
+
+			return queued;
+		}
+
+		// Queues the package to be processed by the first processTriggeredEvents whose tick time has reached
+		// deadline. Safe to call from any number of threads at once. Fails with not_enough_memory when the delayed
+		// lane can not grow.
+		template<EventPackageType Package>
+		[[nodiscard]] std::expected<void, std::error_condition> pushAt(
+			const Package& event_package, std::chrono::steady_clock::time_point deadline
+		)
+		{
+			return _pushDelayed(_delayed_by_time, deadline.time_since_epoch().count(), event_package);
+		}
+
+		// Queues the package to be processed frames calls to processTriggeredEvents from now, 0 and 1 both mean the
+		// next call. Safe to call from any number of threads at once, fails the same way as pushAt.
+		template<EventPackageType Package>
+		[[nodiscard]] std::expected<void, std::error_condition> pushAfterFrames(
+			const Package& event_package, std::uint32_t frames
+		)
+		{
+			const auto deadline = _frame.load(std::memory_order_relaxed) + std::max(frames, std::uint32_t{1});
+
+			return _pushDelayed(_delayed_by_frame, static_cast<std::int64_t>(deadline), event_package);
+		}
+
+		// Packages in the delayed lane that are not due yet.
+		[[nodiscard]] std::size_t getDelayedCount() noexcept
+		{
+			[[maybe_unused]] auto lock = std::scoped_lock(_delayed_mutex);
+
+			return _delayed_by_time.size() + _delayed_by_frame.size();
+		}
+
+		// Every package this queue dispatches from now on is recorded, nullptr stops recording. Not while
+		// processTriggeredEvents is running.
+		void setRecorder(EventRecorder* recorder) noexcept { _recorder = recorder; }
+
+		[[nodiscard]] EventRecorder* getRecorder() const noexcept { return _recorder; }
+
+		// The tick time processTriggeredEvents was last called with.
+		[[nodiscard]] std::chrono::steady_clock::time_point getTickTime() const noexcept { return _tick_time; }
 
-				_rollover = _back;
+		[[nodiscard]] EventQueueOverflow getOverflow() const noexcept { return _overflow; }
 
-				// How about wrapped at the front?
-				if (expected = std::align(alignof(std::max_align_t), sizeof(EventPackageType), aligned, space);
-					!expected
-					)
+		// Whether pushes are going to the overflow chain.
+		[[nodiscard]] bool isOverflowing() const noexcept { return _is_overflowing.load(std::memory_order_relaxed); }
+
+		// Overflow segments holding packages, spare ones are not counted.
+		[[nodiscard]] std::size_t getOverflowSegmentCount() noexcept
+		{
+			[[maybe_unused]] auto lock = std::scoped_lock(_overflow_mutex);
+
+			return _overflow_segment_count;
+		}
+
+		// Makes consumer_thread the only thread that processes the queue, from now on pushes wake it when it is asleep
+		// in waitForEvents. Call it before anything is pushed, a push that races with it may not wake the consumer.
+		void bindConsumerThread(std::thread::id consumer_thread = std::this_thread::get_id()) noexcept
+		{
+			_consumer_thread = consumer_thread;
+			_has_consumer_thread.store(true, std::memory_order_relaxed);
+		}
+
+		// A default constructed id when no thread is bound.
+		[[nodiscard]] std::thread::id getConsumerThread() const noexcept { return _consumer_thread; }
+
+		// Consumer thread only. Returns straight away when there are packages to process, otherwise sleeps until
+		// something is pushed or wakeConsumer is called. Returns whether there are packages to process, false when
+		// only woken by wakeConsumer.
+		bool waitForEvents() noexcept
+		{
+			while (true)
+			{
+				_is_consumer_idle.store(1, std::memory_order_relaxed);
+
+				// Pairs with the fence in _signalConsumer.
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				const bool has_queued_events = _hasQueuedEvents();
+
+				if (has_queued_events || _is_wake_requested.exchange(false, std::memory_order_relaxed))
 				{
-					return std::unexpected(std::make_error_condition(std::errc::not_enough_memory)); // TODO: fail
+					_is_consumer_idle.store(0, std::memory_order_relaxed);
+
+					return has_queued_events;
 				}
+
+				// Returns once a producer or wakeConsumer has set it back to 0.
+				_is_consumer_idle.wait(1, std::memory_order_acquire);
+			}
+		}
+
+		// Wakes the consumer from waitForEvents, or makes its next call return straight away. Safe to call from any
+		// thread, for instance to stop the consumer.
+		void wakeConsumer() noexcept
+		{
+			_is_wake_requested.store(true, std::memory_order_relaxed);
+
+			_signalConsumer();
+		}
+
+		// Processes events as they arrive until stop is requested, sleeping whenever the queue is empty. Meant as the
+		// body of a std::jthread, bind the queue to it with bindConsumerThread(thread.get_id()) before pushing.
+		void runConsumer(std::stop_token stop_token) noexcept
+		{
+			std::stop_callback wake_on_stop(stop_token, [this]() noexcept { wakeConsumer(); });
+
+			while (!stop_token.stop_requested())
+			{
+				if (waitForEvents()) processTriggeredEvents();
 			}
+		}
 
-			_back = static_cast<std::byte*>(aligned) + sizeof(EventPackageType);
+		// Approximate while producers are pushing.
+		[[nodiscard]] EventQueueStatistics getStatistics() const noexcept
+		{
+			EventQueueStatistics statistics{};
 
-			::memcpy_s(aligned, _end - reinterpret_cast<std::byte*>(aligned), &event_package , sizeof(EventPackageType));
+			if constexpr (mt::HAS_EVENT_QUEUE_STATISTICS)
+			{
+				using ticks = std::chrono::steady_clock::duration;
 
-			return {};
+				for (const auto& counters : _counters.push)
+				{
+					statistics.pushes += counters.pushes.load(std::memory_order_relaxed);
+					statistics.pushed_bytes += counters.pushed_bytes.load(std::memory_order_relaxed);
+				}
+
+				const auto& counters = _counters.dispatch;
+
+				statistics.pushes_per_frame = counters.pushes_per_frame.load(std::memory_order_relaxed);
+				statistics.pushed_bytes_per_frame = counters.pushed_bytes_per_frame.load(std::memory_order_relaxed);
+				statistics.used_space_high_water = counters.used_space_high_water.load(std::memory_order_relaxed);
+
+				// The reserve cursor counts every byte the ring has handed out, skipped ones included.
+				statistics.wraparounds = _visitRing(*this, [](const auto& ring) noexcept {
+					return ring.getReserveCursor() / ring.getCapacity();
+				});
+
+				statistics.dispatches_per_frame = counters.dispatches_per_frame.load(std::memory_order_relaxed);
+
+				if (statistics.dispatches_per_frame != 0)
+				{
+					statistics.mean_latency_per_frame = std::chrono::duration_cast<std::chrono::nanoseconds>(ticks{
+						counters.latency_sum_per_frame.load(std::memory_order_relaxed)
+						/ static_cast<std::int64_t>(statistics.dispatches_per_frame)
+					});
+				}
+
+				statistics.max_latency_per_frame = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					ticks{counters.max_latency_per_frame.load(std::memory_order_relaxed)}
+				);
+				statistics.max_latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					ticks{counters.max_latency.load(std::memory_order_relaxed)}
+				);
+			}
+
+			return statistics;
+		}
+
+		[[nodiscard]] EventQueueMode getMode() const noexcept
+		{
+			return std::holds_alternative<LockFreeRing>(_ring) ? EventQueueMode::LOCK_FREE : EventQueueMode::MUTEX;
 		}
 
-		[[nodiscard]] constexpr std::size_t getCapacity() const
+		[[nodiscard]] std::size_t getCapacity() const
 		{
-			return _capacity;
+			return _visitRing(*this, [](const auto& ring) noexcept { return ring.getCapacity(); });
 		}
 
 		[[nodiscard]] std::size_t getUsedSpace()
 		{
-			// b
-			// ooooooFxxxxBooooooE B-F
-			// xxxxxxBooooFxxxxxxE E-F + B-b
-			if (_front == _back)
-				return 0;
-			else if (_front < _back)
-					return _back - _front;
-				else
-					return (_end - _front) + (_back - _start) - std::size_t{1};
+			return _visitRing(*this, [](const auto& ring) noexcept { return ring.getUsedSpace(); });
 		}
 
 		[[nodiscard]] std::size_t getFreeSpace()
 		{
-			if (_front == _back)
-				return (_end - _start) - std::size_t{1};
-			else if (_front < _back)
-					return (_front - _start) + (_end - _back) - std::size_t{1};
-				else
-					return _front - _back;
+			return _visitRing(*this, [](const auto& ring) noexcept { return ring.getFreeSpace(); });
 		}
 
-		// TODO: need a pop? for multithreaded.
-		// Not thread safe, must only ever be called from one thread (tick thread?).
-		void processTriggeredEvents() noexcept
+		// Processes the delayed events that are due at current_tick_time, which should be
+		// TimeManagerInterface::getCurrentTickTime, and then the events that were pushed when it was called. Events
+		// they trigger wait for the next call. Stops early at a package a producer is still copying in, it and
+		// everything after it waits for the next call. Never waits on a producer. Not thread safe, calls must not
+		// overlap. EventManagerInterface::processEvents may make them from different threads in different frames.
+		void processTriggeredEvents(std::chrono::steady_clock::time_point current_tick_time) noexcept
 		{
-			auto back = _back;
-			while (_front != back)
+			const auto frame = _frame.fetch_add(1, std::memory_order_relaxed) + 1;
+
+			_tick_time = current_tick_time;
+
+			_countFrame();
+
 			{
-				auto event_package = reinterpret_cast<EventPackageInterface*>(_front);
+				[[maybe_unused]] auto lock = std::scoped_lock(_delayed_mutex);
 
-				(*event_package)();
+				_takeDueEvents(_delayed_by_frame, static_cast<std::int64_t>(frame));
+				_takeDueEvents(_delayed_by_time, current_tick_time.time_since_epoch().count());
+			}
 
-				_front = _front + event_package->size();
-				if (_front == _rollover || _front == _end)
-				{
-					_front = _start;
-					_rollover = _end;
-				}
+			// Outside the mutex, a handler may push another delayed event.
+			for (auto& due_event : _due_events)
+			{
+				auto package = due_event.package.data();
+
+				reinterpret_cast<const EventPackageHeader*>(package)->invoke(package);
 			}
 
-			if ([[maybe_unused]] auto lock = std::lock_guard(_back_lock);
-				_front == _back
-			)
+			_due_events.clear();
+
+			// Taken before the ring's reserve cursor, so a package in the overflow chain is only processed along with
+			// every package that was pushed to the ring before it.
+			OverflowSegment* last_segment = nullptr;
+			std::size_t last_write = 0;
+
+			if (_is_overflowing.load(std::memory_order_relaxed))
 			{
-				_front = _start;
-				_back = _start;
+				[[maybe_unused]] auto lock = std::scoped_lock(_overflow_mutex);
+
+				last_segment = _overflow_tail;
+				last_write = last_segment ? last_segment->write : 0;
 			}
+
+			DispatchLatency latency{};
+
+			// Whether every package pushed before the reserve cursor was read has been processed.
+			const bool is_ring_drained = _visitRing(*this, [&latency](auto& ring) noexcept {
+				const auto reserve = ring.getReserveCursor();
+
+				// Read after the cursor, so every package that is dispatched was pushed before it.
+				if constexpr (mt::HAS_EVENT_QUEUE_STATISTICS)
+					latency.dispatch_time = std::chrono::steady_clock::now().time_since_epoch().count();
+
+				while (ring.getReleaseCursor() < reserve)
+				{
+					auto record = ring.front(_PACKAGE_ALIGNMENT);
+
+					if (!record) return false;
+
+					auto package = record + PACKAGE_OVERHEAD;
+					const auto& header = *reinterpret_cast<const EventPackageHeader*>(package);
+
+					latency.add(record);
+					header.invoke(package);
+
+					ring.release(PACKAGE_OVERHEAD + header.size);
+				}
+
+				return true;
+			});
+
+			// A package still being copied into the ring holds the overflow chain back too, it may have been pushed
+			// before packages in the chain by the same thread.
+			if (last_segment && is_ring_drained) _processOverflow(last_segment, last_write, latency);
+
+			_countDispatches(latency);
+		}
+
+		void processTriggeredEvents() noexcept
+		{
+			processTriggeredEvents(std::chrono::steady_clock::now());
 		}
 	};
-}
\ No newline at end of file
+}
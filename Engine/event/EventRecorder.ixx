@@ -0,0 +1,276 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module EventRecorder;
+
+import std;
+
+import Error;
+import RingAllocator;
+import ThreadingPolicy;
+import Windows;
+
+using namespace std::literals;
+using namespace mt::error;
+using namespace windows;
+
+export namespace mt::event
+{
+	// An event log is an EventLogHeader followed by records packed back to back with no padding. A record is the
+	// fields of an EventRecordHeader, EVENT_RECORD_HEADER_SIZE bytes, followed by payload_size bytes of payload, the
+	// EventParameters of the event as they were in memory. Logs can only be played back on the platform they were
+	// recorded on.
+	constexpr std::array<char, 4> EVENT_LOG_MAGIC{'M', 'T', 'E', 'L'};
+	constexpr std::uint32_t EVENT_LOG_VERSION = 1;
+
+	struct EventLogHeader
+	{
+		std::array<char, 4> magic = EVENT_LOG_MAGIC;
+		std::uint32_t version = EVENT_LOG_VERSION;
+	};
+
+	struct EventRecordHeader
+	{
+		// Name::hash of the event.
+		std::uint64_t name_hash;
+		// steady_clock ticks of the tick time the event was processed at.
+		std::int64_t tick_time;
+		std::uint32_t payload_size;
+	};
+
+	constexpr std::size_t EVENT_RECORD_HEADER_SIZE =
+		sizeof(EventRecordHeader::name_hash) + sizeof(EventRecordHeader::tick_time)
+		+ sizeof(EventRecordHeader::payload_size);
+
+	// record does not have to be aligned.
+	[[nodiscard]] EventRecordHeader readEventRecordHeader(const std::byte* record) noexcept
+	{
+		EventRecordHeader header;
+
+		std::memcpy(&header.name_hash, record, sizeof(header.name_hash));
+		record += sizeof(header.name_hash);
+		std::memcpy(&header.tick_time, record, sizeof(header.tick_time));
+		record += sizeof(header.tick_time);
+		std::memcpy(&header.payload_size, record, sizeof(header.payload_size));
+
+		return header;
+	}
+
+	void writeEventRecordHeader(std::byte* record, const EventRecordHeader& header) noexcept
+	{
+		std::memcpy(record, &header.name_hash, sizeof(header.name_hash));
+		record += sizeof(header.name_hash);
+		std::memcpy(record, &header.tick_time, sizeof(header.tick_time));
+		record += sizeof(header.tick_time);
+		std::memcpy(record, &header.payload_size, sizeof(header.payload_size));
+	}
+
+	// Appends the events it is handed to an event log, EventPlayer plays one back. Attach it to the queues to record
+	// with EventQueue::setRecorder or EventManagerInterface::setRecorder.
+	//
+	// record copies the event into a lock free staging ring and returns, so every thread that drains a queue can
+	// record at once. A background thread moves records from the ring to the end of the file, which is mapped into
+	// memory and grown as it fills, and cut to the length of the log when the recorder is destroyed. record never
+	// waits: when the writer falls far enough behind to fill the ring the event is dropped and counted.
+	class EventRecorder
+	{
+		static constexpr std::size_t _RECORD_ALIGNMENT = alignof(std::uint64_t);
+		static constexpr std::size_t _INITIAL_FILE_SIZE = 1 << 20;
+		// How long the writer sleeps when there is nothing to write.
+		static constexpr std::chrono::milliseconds _WRITER_SLEEP = 1ms;
+
+		mt::memory::RingAllocator<mt::memory::LockFreePolicy> _staging;
+		std::atomic<std::size_t> _dropped_count = 0;
+		bool _is_open = false;
+
+		// Owned by the writer once it has started.
+		HANDLE _file = INVALID_HANDLE_VALUE;
+		HANDLE _mapping = nullptr;
+		std::byte* _view = nullptr;
+		std::size_t _mapped_size = 0;
+		std::size_t _log_size = 0;
+
+		// Last, so it stops before anything it uses is destroyed.
+		std::jthread _writer;
+
+		// Maps size bytes of the file, growing it if it is shorter.
+		[[nodiscard]] bool _map(std::size_t size) noexcept
+		{
+			if (_view) UnmapViewOfFile(_view);
+			if (_mapping) CloseHandle(_mapping);
+
+			_view = nullptr;
+			_mapping = nullptr;
+			_mapped_size = 0;
+
+			const auto size_64 = static_cast<std::uint64_t>(size);
+
+			_mapping = CreateFileMappingW(
+				_file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size_64 >> 32), static_cast<DWORD>(size_64), nullptr
+			);
+
+			if (!_mapping) return false;
+
+			_view = static_cast<std::byte*>(MapViewOfFile(_mapping, FILE_MAP_WRITE, 0, 0, size));
+
+			if (!_view) return false;
+
+			_mapped_size = size;
+
+			return true;
+		}
+
+		// Moves everything committed to the staging ring into the file, returns the number of records it moved.
+		std::size_t _writeStaged() noexcept
+		{
+			std::size_t record_count = 0;
+
+			while (auto record = _staging.front(_RECORD_ALIGNMENT))
+			{
+				const auto size = EVENT_RECORD_HEADER_SIZE + readEventRecordHeader(record).payload_size;
+
+				// The file at least doubles when it grows, so remapping is rare.
+				if (_log_size + size <= _mapped_size || _map(std::max(_mapped_size * 2, _log_size + size)))
+				{
+					std::memcpy(_view + _log_size, record, size);
+					_log_size += size;
+				}
+				else
+				{
+					_dropped_count.fetch_add(1, std::memory_order_relaxed);
+				}
+
+				_staging.release(size);
+				++record_count;
+			}
+
+			return record_count;
+		}
+
+		void _write(std::stop_token stop_token) noexcept
+		{
+			if (SetThreadDescription(GetCurrentThread(), L"mt::Engine Event Recorder") < 0)
+				OutputDebugString(L"failed to set event recorder thread name.");
+
+			while (true)
+			{
+				// Read before writing, so everything recorded before the stop was requested reaches the file.
+				const bool is_stopping = stop_token.stop_requested();
+
+				if (_writeStaged() == 0 && !is_stopping) std::this_thread::sleep_for(_WRITER_SLEEP);
+
+				if (is_stopping) return;
+			}
+		}
+
+		void _close() noexcept
+		{
+			if (_view) UnmapViewOfFile(_view);
+			if (_mapping) CloseHandle(_mapping);
+
+			if (_file != INVALID_HANDLE_VALUE)
+			{
+				// The mapping grows the file ahead of the log, cut it back.
+				LARGE_INTEGER log_size{};
+				log_size.QuadPart = static_cast<LONGLONG>(_log_size);
+
+				if (SetFilePointerEx(_file, log_size, nullptr, FILE_BEGIN)) SetEndOfFile(_file);
+
+				CloseHandle(_file);
+			}
+
+			_view = nullptr;
+			_mapping = nullptr;
+			_file = INVALID_HANDLE_VALUE;
+		}
+
+	public:
+		// Replaces the file at path. staging_size is how many bytes of records can wait for the writer.
+		EventRecorder(
+			const std::filesystem::path& path, std::error_condition& error, std::size_t staging_size = 1 << 22
+		) noexcept
+			: _staging(staging_size, error)
+		{
+			if (error) return;
+
+			_file = CreateFileW(
+				path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+				FILE_ATTRIBUTE_NORMAL, nullptr
+			);
+
+			if (_file == INVALID_HANDLE_VALUE || !_map(_INITIAL_FILE_SIZE))
+			{
+				_close();
+				Assign(error, ErrorCode::EVENT_LOG_OPEN_FAILED);
+				return;
+			}
+
+			constexpr EventLogHeader log_header{};
+			std::memcpy(_view, &log_header, sizeof(log_header));
+			_log_size = sizeof(log_header);
+
+			try
+			{
+				_writer = std::jthread([this](std::stop_token stop_token) noexcept { _write(stop_token); });
+			}
+			catch (...)
+			{
+				_close();
+				Assign(error, ErrorCode::EVENT_LOG_OPEN_FAILED);
+				return;
+			}
+
+			_is_open = true;
+		}
+
+		// Nothing may record any more. Writes out what is still staged.
+		~EventRecorder() noexcept
+		{
+			if (_writer.joinable())
+			{
+				_writer.request_stop();
+				_writer.join();
+			}
+
+			_close();
+		}
+
+		EventRecorder(const EventRecorder&) = delete;
+		EventRecorder(EventRecorder&&) = delete;
+		EventRecorder& operator=(const EventRecorder&) = delete;
+		EventRecorder& operator=(EventRecorder&&) = delete;
+
+		// Safe to call from any number of threads at once, never waits. Returns false when the event was dropped.
+		bool record(
+			std::uint64_t name_hash, std::chrono::steady_clock::time_point tick_time, std::span<const std::byte> payload
+		) noexcept
+		{
+			if (!_is_open || payload.size() > std::numeric_limits<std::uint32_t>::max()) return false;
+
+			const auto size = EVENT_RECORD_HEADER_SIZE + payload.size();
+
+			auto allocation = _staging.allocate(size, _RECORD_ALIGNMENT);
+
+			if (!allocation)
+			{
+				_dropped_count.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			writeEventRecordHeader(allocation.data, EventRecordHeader{
+				name_hash, tick_time.time_since_epoch().count(), static_cast<std::uint32_t>(payload.size())
+			});
+			std::memcpy(allocation.data + EVENT_RECORD_HEADER_SIZE, payload.data(), payload.size());
+
+			_staging.commit(allocation);
+
+			return true;
+		}
+
+		[[nodiscard]] bool isOpen() const noexcept { return _is_open; }
+
+		// Events that were handed to record and will not be in the log.
+		[[nodiscard]] std::size_t getDroppedCount() const noexcept
+		{
+			return _dropped_count.load(std::memory_order_relaxed);
+		}
+	};
+}
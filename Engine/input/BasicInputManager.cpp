@@ -25,15 +25,18 @@ using namespace std::literals;
 
 void BasicInputManager::processInput() noexcept
 {
-	auto size = _input_queue.size();
+	_input_messages.receive();
 
-	std::set<InputType> pressed_buttons{};
+	auto size = _input_messages.size();
+
+	// Only lives for this call, so it comes out of the frame arena instead of the heap.
+	std::pmr::set<InputType> pressed_buttons{&_engine.getRenderer()->getFrameArena()};
 
 	auto default_constructed_input_type = InputType();
 
 	for (auto x = 0u; x < size; x++)
 	{
-		InputMessage& input_message = *_input_queue.front();
+		InputMessage& input_message = _input_messages.front();
 
 		const auto& input_type = input_message.input_type;
 
@@ -190,7 +193,7 @@ void BasicInputManager::processInput() noexcept
 						}
 					}
 					_held_buttons.clear();
-					_input_queue.pop();
+					_input_messages.pop();
 					continue;
 				}
 				else if (input_type == InputType(
@@ -203,8 +206,8 @@ void BasicInputManager::processInput() noexcept
 				break;
 		}
 
-		// This causes the smart pointer to release
-		_input_queue.pop();
+		// Releases the message back to its pool.
+		_input_messages.pop();
 	}
 
 	// Trigger the held buttons.
@@ -214,10 +217,9 @@ void BasicInputManager::processInput() noexcept
 			(*it->second)();
 	}
 
-	_held_buttons.merge(pressed_buttons);
+	_held_buttons.insert(pressed_buttons.begin(), pressed_buttons.end());
 
-	if (_message_pool.size() < _message_pool.capacity())
-		is_accepting_input.store(true);
+	_input_messages.resume();
 }
 
 void mt::input::BasicInputManager::acceptInput(
@@ -225,22 +227,19 @@ void mt::input::BasicInputManager::acceptInput(
 ) noexcept
 {
 	if (isAcceptingInput()){
-		if (auto pointer = _message_pool.allocate(input_type, std::chrono::steady_clock::now(), data); pointer)
-		{
-			_input_queue.push(std::move(pointer));
-
-			if (_message_pool.size() == _message_pool.capacity())
-				is_accepting_input.store(false);
-		}
-		else {
-			_engine.crash(MakeErrorCondition(ErrorCode::UNABLE_TO_ACCEPT_INPUT));
-		}
+		// A message there is no room for is dropped, and input is paused until processInput has released some.
+		_input_messages.push(input_type, data);
 	}
 	else {
 		_engine.crash(MakeErrorCondition(mt::error::ErrorCode::CALLED_WHILE_NOT_ACCEPTING_INPUT));
 	}
 }
 
+void mt::input::BasicInputManager::publishInput() noexcept
+{
+	_input_messages.publish();
+}
+
 void mt::input::BasicInputManager::toggleIsMouseRelative() noexcept
 {
 	if (getIsMouseRelative())
@@ -3,7 +3,7 @@ export module BasicInputManager;
 
 import std;
 import Engine;
-import ObjectPool;
+import InputMessageQueue;
 import Windows;
 
 using namespace windows;
@@ -16,33 +16,38 @@ export namespace mt::input
 {
 	class BasicInputManager : public InputManagerInterface
 	{
-		static const std::size_t POOL_SIZE = 2048;
+		// Filled by acceptInput and handed over by publishInput on the windows message thread, drained by processInput
+		// on the tick thread.
+		InputMessageQueue _input_messages;
 
-		mt::memory::ObjectPool<InputMessage, POOL_SIZE> _message_pool;
-
-		std::queue<mt::memory::ObjectPool<InputMessage, POOL_SIZE>::unique_ptr_t> _input_queue;
-
-		std::multimap<InputType, not_null<Task*>>              				button_input_handler;
-		std::multimap<InputType, not_null<OneDimensionalInputTask*>>    	one_dimensional_input_handler;
-		std::multimap<InputType, not_null<TwoDimensionalInputTask*>>    	two_dimensional_input_handler;
-		std::multimap<InputType, not_null<ThreeDimensionalInputTask*>>  	three_dimensional_input_handler;
+		std::pmr::multimap<InputType, not_null<Task*>>              			button_input_handler;
+		std::pmr::multimap<InputType, not_null<OneDimensionalInputTask*>>    	one_dimensional_input_handler;
+		std::pmr::multimap<InputType, not_null<TwoDimensionalInputTask*>>    	two_dimensional_input_handler;
+		std::pmr::multimap<InputType, not_null<ThreeDimensionalInputTask*>>  	three_dimensional_input_handler;
 
 		// Windows will only send the last key pressed as being held, so if you press A, B, C and hold them all down,
 		// you will only get held messages for C. The engine should be propagating held messages each frame for A,B and C though.
-		std::set<InputType> _held_buttons{};
+		std::pmr::set<InputType> _held_buttons;
 
 		POINT _mouse_return_position{};
-
-		std::atomic<bool> is_accepting_input = true;
 	protected:
 		mt::Engine& _engine;
 
 		virtual void processInput() noexcept override;
 
 	public:
-		BasicInputManager(mt::Engine& engine, std::error_condition& error) noexcept
-			: _engine(engine)
-			, _message_pool(mt::memory::ObjectPool<InputMessage, POOL_SIZE>(error))
+		BasicInputManager(
+			mt::Engine& engine,
+			std::error_condition& error,
+			std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource()
+		) noexcept
+			: _input_messages(error)
+			, button_input_handler(memory_resource)
+			, one_dimensional_input_handler(memory_resource)
+			, two_dimensional_input_handler(memory_resource)
+			, three_dimensional_input_handler(memory_resource)
+			, _held_buttons(memory_resource)
+			, _engine(engine)
 		{
 
 		};
@@ -59,7 +64,7 @@ export namespace mt::input
 
 		virtual bool isAcceptingInput() const noexcept
 		{
-			return is_accepting_input;
+			return _input_messages.isAccepting();
 		}
 
 		virtual void acceptInput(
@@ -67,6 +72,8 @@ export namespace mt::input
 			std::variant<std::monostate, InputData1D, InputData2D, InputData3D> data = std::monostate()
 		) noexcept override;
 
+		virtual void publishInput() noexcept override;
+
 		virtual void toggleIsMouseRelative() noexcept override;
 
 		virtual void registerInputHandler(InputHandler input_handler, InputType input_types) noexcept override;
@@ -43,6 +43,9 @@ export namespace mt::input
 			std::variant<std::monostate, InputData1D, InputData2D, InputData3D> data = std::monostate()
         ) noexcept = 0;
 
+		// Hands the input accepted since the last call to processInput, once per windows message pump iteration.
+		virtual void publishInput() noexcept = 0;
+
 		virtual void toggleIsMouseRelative() noexcept  = 0;
 
         virtual void registerInputHandler(InputHandler input_handler, InputType input_types) noexcept = 0;
@@ -0,0 +1,202 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module InputMessageQueue;
+
+import std;
+
+import BackingStore;
+import Error;
+import FramePacket;
+import InputModel;
+import LockFreeObjectPool;
+import MemoryTracking;
+import PagedObjectPool;
+
+using namespace mt::error;
+using namespace mt::input::model;
+using namespace mt::memory;
+
+export namespace mt::input
+{
+	// What one iteration of the windows message pump handed over, the messages in the ring up to end. Cursors only
+	// grow, so a packet the tick thread never sees is covered by the next one.
+	struct InputPacket
+	{
+		std::uint64_t end = 0;
+	};
+
+	// Hands input messages from the windows message thread to the tick thread.
+	//
+	// Messages are allocated on the message thread and released on the tick thread, out of a lock free pool or, once
+	// a burst has exhausted it, a paged overflow pool. Their pointers pass through a single producer single consumer
+	// ring. The message thread fills slots for a whole pump iteration and then publishes them in an InputPacket, the
+	// tick thread picks up the newest packet, reads up to its end and then moves the pop cursor. Neither thread ever
+	// waits on the other.
+	//
+	// A message that neither the pools nor the ring have room for is dropped, and the queue stops accepting input
+	// until the tick thread has made room again.
+	class InputMessageQueue
+	{
+	public:
+		static constexpr std::size_t POOL_SIZE = 2048;
+		static constexpr std::size_t MAGAZINE_SIZE = 32;
+
+		// The tick thread's magazine can hold free slots the message thread is unable to reach.
+		static constexpr std::size_t USABLE_POOL_SIZE = POOL_SIZE - MAGAZINE_SIZE;
+
+		// Pages the overflow pool may grow to, a few message pools worth. Past that input pauses, so a stalled tick
+		// thread or a flood of input can not grow it until allocation fails.
+		static constexpr std::size_t MAX_OVERFLOW_PAGES =
+			(4 * POOL_SIZE + PagedObjectPool<InputMessage>::objectsPerPage() - 1)
+				/ PagedObjectPool<InputMessage>::objectsPerPage();
+
+		// Every message both pools can hold, so the ring never fills up before they do.
+		static constexpr std::size_t CAPACITY =
+			POOL_SIZE + MAX_OVERFLOW_PAGES * PagedObjectPool<InputMessage>::objectsPerPage();
+
+	private:
+		using MessagePool = LockFreeObjectPool<InputMessage, POOL_SIZE, MAGAZINE_SIZE, PrefaultedBackingStore>;
+		using OverflowPool = PagedObjectPool<InputMessage>;
+		using MessagePointer = std::variant<MessagePool::unique_ptr_t, OverflowPool::unique_ptr_t>;
+
+		static constexpr std::size_t _CACHE_LINE = std::hardware_destructive_interference_size;
+		static constexpr std::size_t _RING_BYTES = sizeof(std::optional<MessagePointer>) * CAPACITY;
+
+		// Each thread works out of its own magazine of slots and only touches the shared free list in batches. The pool
+		// is prefaulted so the first burst of input does not page fault on the message thread.
+		MessagePool _message_pool;
+
+		// Grows with a burst that exhausts the message pool instead of dropping it, up to MAX_OVERFLOW_PAGES.
+		OverflowPool _overflow_pool;
+
+		// Declared after the pools, the messages still in it are released before the pools go away.
+		std::unique_ptr<std::optional<MessagePointer>[]> _ring;
+
+		// Owned by the message thread, the tick thread only sees it through a published packet.
+		alignas(_CACHE_LINE) std::uint64_t _push = 0;
+
+		FramePacketExchange<InputPacket> _packets{};
+
+		// Written by the tick thread.
+		alignas(_CACHE_LINE) std::atomic<std::uint64_t> _pop = 0;
+
+		// Cleared by the message thread when it drops a message, set again by the tick thread.
+		alignas(_CACHE_LINE) std::atomic<bool> _is_accepting = true;
+
+		[[nodiscard]] std::optional<MessagePointer>& _getSlot(std::uint64_t cursor) noexcept
+		{
+			return _ring[cursor % CAPACITY];
+		}
+
+	public:
+		explicit InputMessageQueue(std::error_condition& error) noexcept
+			: _message_pool(error, MemoryTag::INPUT)
+			, _overflow_pool(error, 1, MAX_OVERFLOW_PAGES, MemoryTag::INPUT)
+			, _ring(new (std::nothrow) std::optional<MessagePointer>[CAPACITY])
+		{
+			if (!_ring)
+			{
+				Assign(error, ErrorCode::BAD_ALLOCATION);
+			}
+			else
+			{
+				MemoryTracker::global().recordReserve(MemoryTag::INPUT, _RING_BYTES);
+			}
+		}
+
+		~InputMessageQueue() noexcept
+		{
+			if (_ring) MemoryTracker::global().recordUnreserve(MemoryTag::INPUT, _RING_BYTES);
+		}
+
+		InputMessageQueue(const InputMessageQueue&) = delete;
+		InputMessageQueue(InputMessageQueue&&) = delete;
+		InputMessageQueue& operator=(const InputMessageQueue&) = delete;
+		InputMessageQueue& operator=(InputMessageQueue&&) = delete;
+
+		// Message thread only.
+		[[nodiscard]] bool isAccepting() const noexcept { return _is_accepting.load(std::memory_order_relaxed); }
+
+		// Message thread only. Returns false when the message had to be dropped.
+		bool push(
+			InputType input_type,
+			std::variant<std::monostate, InputData1D, InputData2D, InputData3D> data = std::monostate()
+		) noexcept
+		{
+			// Acquire, so the tick thread is done with the slot before it is filled again.
+			bool is_queued = _push - _pop.load(std::memory_order_acquire) < CAPACITY;
+
+			if (is_queued)
+			{
+				const auto now = std::chrono::steady_clock::now();
+
+				if (auto pointer = _message_pool.allocate(input_type, now, data); pointer)
+					_getSlot(_push).emplace(std::move(pointer));
+				else if (auto overflow_pointer = _overflow_pool.allocate(input_type, now, data); overflow_pointer)
+					_getSlot(_push).emplace(std::move(overflow_pointer));
+				else
+					is_queued = false;
+			}
+
+			if (!is_queued)
+			{
+				_is_accepting.store(false, std::memory_order_relaxed);
+				return false;
+			}
+
+			++_push;
+
+			return true;
+		}
+
+		// Message thread only. Hands the messages pushed since the last call to the tick thread, once per pump
+		// iteration.
+		void publish() noexcept
+		{
+			_packets.getWritePacket().end = _push;
+			_packets.publish();
+		}
+
+		// Tick thread only. Picks up the messages published since the last call.
+		void receive() noexcept
+		{
+			_packets.update();
+		}
+
+		// Tick thread only. Messages received and not popped yet.
+		[[nodiscard]] std::size_t size() const noexcept
+		{
+			return _packets.getReadPacket().end - _pop.load(std::memory_order_relaxed);
+		}
+
+		// Tick thread only. The oldest message, the queue must not be empty.
+		[[nodiscard]] InputMessage& front() noexcept
+		{
+			return std::visit(
+				[](auto& pointer) -> InputMessage& { return *pointer; }, *_getSlot(_pop.load(std::memory_order_relaxed))
+			);
+		}
+
+		// Tick thread only. Releases the oldest message back to its pool.
+		void pop() noexcept
+		{
+			const auto pop = _pop.load(std::memory_order_relaxed);
+
+			_getSlot(pop).reset();
+
+			_pop.store(pop + 1, std::memory_order_release);
+		}
+
+		// Tick thread only. Accepts input again once the ring and both pools have room, call it after popping. Messages
+		// the message thread has pushed and not published yet are in the pools but not counted by size().
+		void resume() noexcept
+		{
+			if (size() < CAPACITY
+				&& _message_pool.size() < USABLE_POOL_SIZE
+				&& _overflow_pool.size() < _overflow_pool.capacity()
+			)
+			{
+				_is_accepting.store(true, std::memory_order_relaxed);
+			}
+		}
+	};
+}
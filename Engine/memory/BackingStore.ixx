@@ -0,0 +1,139 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module BackingStore;
+
+import std;
+
+import Windows;
+
+using namespace windows;
+
+namespace mt::memory
+{
+	[[nodiscard]] std::size_t getPageSize() noexcept
+	{
+		static const std::size_t page_size = []() noexcept {
+			SYSTEM_INFO system_info;
+			GetSystemInfo(&system_info);
+			return static_cast<std::size_t>(system_info.dwPageSize);
+		}();
+
+		return page_size;
+	}
+
+	// Large pages need SeLockMemoryPrivilege, which has to be granted to the user and then enabled on the process
+	// token.
+	[[nodiscard]] bool enableLockMemoryPrivilege() noexcept
+	{
+		static const bool is_enabled = []() noexcept {
+			HANDLE token;
+			if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) return false;
+
+			TOKEN_PRIVILEGES privileges{};
+			privileges.PrivilegeCount = 1;
+			privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+			bool enabled = LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid)
+				&& AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr)
+				// AdjustTokenPrivileges succeeds even when the privilege was not granted.
+				&& GetLastError() == ERROR_SUCCESS;
+
+			CloseHandle(token);
+
+			return enabled;
+		}();
+
+		return is_enabled;
+	}
+
+	// Commits the memory and writes to every page of it, so none of the page faults happen mid frame.
+	[[nodiscard]] void* allocatePrefaulted(std::size_t bytes) noexcept
+	{
+		auto data = static_cast<std::byte*>(VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+
+		if (data == nullptr) return nullptr;
+
+		const auto page_size = getPageSize();
+		for (auto offset = std::size_t{0}; offset < bytes; offset += page_size)
+		{
+			*static_cast<volatile std::byte*>(data + offset) = std::byte{0};
+		}
+
+		return data;
+	}
+}
+
+export namespace mt::memory
+{
+	// Backing store policies for the memory a pool or queue is carved out of. Each provides allocate, which returns
+	// nullptr on failure, and deallocate, which is safe to call with nullptr. deallocate has the signature of
+	// std::free so it can be stored as a plain function pointer.
+
+	// Plain malloc, pages are faulted in the first time each one is touched.
+	struct MallocBackingStore
+	{
+		[[nodiscard]] static void* allocate(std::size_t bytes) noexcept { return std::malloc(bytes); }
+
+		static void deallocate(void* data) noexcept { std::free(data); }
+	};
+
+	// Committed and touched up front, the faults all happen when the owner is constructed.
+	struct PrefaultedBackingStore
+	{
+		[[nodiscard]] static void* allocate(std::size_t bytes) noexcept { return allocatePrefaulted(bytes); }
+
+		static void deallocate(void* data) noexcept
+		{
+			if (data) VirtualFree(data, 0, MEM_RELEASE);
+		}
+	};
+
+	// Prefaulted and then locked into the working set when the process is allowed to, so it is never paged back out.
+	// Locking is best effort, the memory is still usable when the working set is too small to hold it.
+	struct LockedBackingStore
+	{
+		[[nodiscard]] static void* allocate(std::size_t bytes) noexcept
+		{
+			auto data = allocatePrefaulted(bytes);
+
+			if (data) VirtualLock(data, bytes);
+
+			return data;
+		}
+
+		static void deallocate(void* data) noexcept { PrefaultedBackingStore::deallocate(data); }
+	};
+
+	// Backed by large pages, which covers the whole allocation with a handful of TLB entries. Large pages are always
+	// resident and locked. Falls back to LockedBackingStore when the process lacks SeLockMemoryPrivilege or there is
+	// not enough contiguous physical memory.
+	struct LargePageBackingStore
+	{
+		[[nodiscard]] static void* allocate(std::size_t bytes) noexcept
+		{
+			if (const auto large_page_size = GetLargePageMinimum(); large_page_size != 0 && enableLockMemoryPrivilege())
+			{
+				const auto rounded_bytes = (bytes + large_page_size - 1) / large_page_size * large_page_size;
+
+				if (auto data = VirtualAlloc(
+						nullptr, rounded_bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE
+					);
+					data
+				)
+				{
+					return data;
+				}
+			}
+
+			return LockedBackingStore::allocate(bytes);
+		}
+
+		static void deallocate(void* data) noexcept { PrefaultedBackingStore::deallocate(data); }
+	};
+
+	template<typename BackingStore>
+	concept BackingStorePolicy = requires(std::size_t bytes, void* data)
+	{
+		{ BackingStore::allocate(bytes) } -> std::same_as<void*>;
+		BackingStore::deallocate(data);
+	};
+}
@@ -0,0 +1,277 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module EpochReclamation;
+
+import std;
+
+import Error;
+
+using namespace mt::error;
+
+export namespace mt::memory
+{
+	class EpochDomain;
+	class EpochGuard;
+
+	// A thread's registration with an EpochDomain. Owned by the thread that registered, it is what a reader pins to
+	// the current epoch. Unregisters when destroyed.
+	class EpochParticipant
+	{
+		friend class EpochDomain;
+		friend class EpochGuard;
+
+		std::atomic<std::uint64_t>* _epoch = nullptr;
+		std::atomic<bool>* _is_registered = nullptr;
+		const std::atomic<std::uint64_t>* _domain_epoch = nullptr;
+		std::size_t _pin_depth = 0;
+
+		EpochParticipant(
+			std::atomic<std::uint64_t>& epoch,
+			std::atomic<bool>& is_registered,
+			const std::atomic<std::uint64_t>& domain_epoch
+		) noexcept
+			: _epoch(&epoch)
+			, _is_registered(&is_registered)
+			, _domain_epoch(&domain_epoch)
+		{}
+
+		void _pin() noexcept;
+		void _unpin() noexcept;
+
+	public:
+		EpochParticipant() noexcept = default;
+
+		~EpochParticipant() noexcept
+		{
+			if (_is_registered)
+			{
+				_epoch->store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_release);
+				_is_registered->store(false, std::memory_order_release);
+			}
+		}
+
+		EpochParticipant(const EpochParticipant&) = delete;
+		EpochParticipant& operator=(const EpochParticipant&) = delete;
+
+		EpochParticipant(EpochParticipant&& other) noexcept
+			: _epoch(std::exchange(other._epoch, nullptr))
+			, _is_registered(std::exchange(other._is_registered, nullptr))
+			, _domain_epoch(std::exchange(other._domain_epoch, nullptr))
+			, _pin_depth(std::exchange(other._pin_depth, 0))
+		{}
+
+		EpochParticipant& operator=(EpochParticipant&& other) noexcept
+		{
+			std::swap(_epoch, other._epoch);
+			std::swap(_is_registered, other._is_registered);
+			std::swap(_domain_epoch, other._domain_epoch);
+			std::swap(_pin_depth, other._pin_depth);
+			return *this;
+		}
+
+		// Nothing the thread reads while the guard lives is reclaimed until the guard is destroyed. Pins nest, only the
+		// outermost one does any work. Wait free.
+		[[nodiscard]] EpochGuard pin() noexcept;
+
+		[[nodiscard]] bool isPinned() const noexcept { return _pin_depth != 0; }
+	};
+
+	// Keeps its participant pinned while it lives.
+	class EpochGuard
+	{
+		EpochParticipant* _participant;
+
+	public:
+		explicit EpochGuard(EpochParticipant& participant) noexcept
+			: _participant(&participant)
+		{
+			_participant->_pin();
+		}
+
+		~EpochGuard() noexcept
+		{
+			if (_participant) _participant->_unpin();
+		}
+
+		EpochGuard(const EpochGuard&) = delete;
+		EpochGuard& operator=(const EpochGuard&) = delete;
+		EpochGuard(EpochGuard&& other) noexcept : _participant(std::exchange(other._participant, nullptr)) {}
+		EpochGuard& operator=(EpochGuard&&) = delete;
+	};
+
+	// Defers reclaiming memory that other threads may still be reading.
+	//
+	// Readers register once, then pin themselves for as long as they hold pointers to shared objects. A writer that
+	// unlinks an object retires it instead of freeing it. The tick thread calls advance() once a frame, which moves the
+	// global epoch on once every pinned participant has caught up with it. An object retired in epoch E is reclaimed
+	// when the epoch moves to E + 2, by then every participant has unpinned or been seen in E + 1, after the object
+	// was unlinked. A participant that stays pinned holds the epoch back and so delays all reclamation, pins should
+	// last no longer than a frame.
+	//
+	// pin and unpin are wait free and touch only the participant's own cache line. retire takes a mutex, it is meant
+	// for the rare case of replacing shared data, not for every allocation.
+	class EpochDomain
+	{
+	public:
+		static constexpr std::size_t MAX_PARTICIPANTS = 64;
+
+	private:
+		static constexpr std::uint64_t _INACTIVE = std::numeric_limits<std::uint64_t>::max();
+		// Objects retired in the current epoch and the two before it.
+		static constexpr std::size_t _RETIRED_LIST_COUNT = 3;
+
+		struct alignas(std::hardware_destructive_interference_size) Participant
+		{
+			std::atomic<std::uint64_t> epoch = _INACTIVE;
+			std::atomic<bool> is_registered = false;
+		};
+
+		struct RetiredObject
+		{
+			void* pointer;
+			void* context;
+			void (*reclaim)(void* context, void* pointer) noexcept;
+		};
+
+		alignas(std::hardware_destructive_interference_size) std::atomic<std::uint64_t> _epoch = 0;
+		std::array<Participant, MAX_PARTICIPANTS> _participants{};
+
+		std::mutex _retired_mutex;
+		std::array<std::vector<RetiredObject>, _RETIRED_LIST_COUNT> _retired{};
+		std::atomic<std::size_t> _retired_count = 0;
+
+		// Only used by advance(), so reclaiming happens outside the mutex without allocating.
+		std::vector<RetiredObject> _reclaiming{};
+
+		void _reclaim(std::vector<RetiredObject>& retired) noexcept
+		{
+			for (const auto& object : retired) object.reclaim(object.context, object.pointer);
+
+			_retired_count.fetch_sub(retired.size(), std::memory_order_relaxed);
+			retired.clear();
+		}
+
+	public:
+		EpochDomain() noexcept = default;
+
+		// Every participant must be gone, whatever is still retired is reclaimed.
+		~EpochDomain() noexcept
+		{
+			for (auto& retired : _retired) _reclaim(retired);
+		}
+
+		EpochDomain(const EpochDomain&) = delete;
+		EpochDomain(EpochDomain&&) = delete;
+		EpochDomain& operator=(const EpochDomain&) = delete;
+		EpochDomain& operator=(EpochDomain&&) = delete;
+
+		// The domain StandardTickFunction advances every frame.
+		[[nodiscard]] static EpochDomain& global() noexcept
+		{
+			static EpochDomain domain;
+			return domain;
+		}
+
+		// Registers the calling thread, fails with TOO_MANY_EPOCH_PARTICIPANTS once MAX_PARTICIPANTS are registered.
+		[[nodiscard]] std::expected<EpochParticipant, std::error_condition> registerParticipant() noexcept
+		{
+			for (auto& participant : _participants)
+			{
+				if (bool is_registered = false; participant.is_registered.compare_exchange_strong(
+					is_registered, true, std::memory_order_acquire
+				))
+				{
+					return EpochParticipant(participant.epoch, participant.is_registered, _epoch);
+				}
+			}
+
+			return std::unexpected(MakeErrorCondition(ErrorCode::TOO_MANY_EPOCH_PARTICIPANTS));
+		}
+
+		// Hands the object to reclaim(context, pointer) once no participant can still be reading it. The object must
+		// already be unreachable for readers that pin from now on.
+		void retire(void* pointer, void* context, void (*reclaim)(void* context, void* pointer) noexcept) noexcept
+		{
+			[[maybe_unused]] auto lock = std::scoped_lock(_retired_mutex);
+
+			// Read under the mutex, advance() can not move the epoch on between this and the push.
+			const auto epoch = _epoch.load(std::memory_order_relaxed);
+
+			_retired[epoch % _RETIRED_LIST_COUNT].push_back(RetiredObject{pointer, context, reclaim});
+			_retired_count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Deletes pointer once no participant can still be reading it.
+		template<typename T>
+		void retire(T* pointer) noexcept
+		{
+			retire(pointer, nullptr, [](void*, void* object) noexcept { delete static_cast<T*>(object); });
+		}
+
+		// Moves the epoch on and reclaims what was retired two epochs ago, unless a participant is still pinned in an
+		// earlier epoch. Returns whether the epoch moved. Only one thread may advance a domain, the tick thread.
+		bool advance() noexcept
+		{
+			const auto epoch = _epoch.load(std::memory_order_relaxed);
+
+			// Pairs with the fence in EpochParticipant::_pin, a participant is either seen pinned here or sees
+			// everything that was unlinked before it pinned.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			for (const auto& participant : _participants)
+			{
+				if (const auto participant_epoch = participant.epoch.load(std::memory_order_relaxed);
+					participant_epoch != _INACTIVE && participant_epoch != epoch
+				)
+				{
+					return false;
+				}
+			}
+
+			{
+				[[maybe_unused]] auto lock = std::scoped_lock(_retired_mutex);
+
+				_epoch.store(epoch + 1, std::memory_order_seq_cst);
+
+				// Objects retired in epoch - 1, the list is empty again in time for epoch + 2.
+				std::swap(_reclaiming, _retired[(epoch + 2) % _RETIRED_LIST_COUNT]);
+			}
+
+			_reclaim(_reclaiming);
+
+			return true;
+		}
+
+		[[nodiscard]] std::uint64_t getEpoch() const noexcept
+		{
+			return _epoch.load(std::memory_order_relaxed);
+		}
+
+		// Objects retired and not reclaimed yet, it only grows while a participant holds the epoch back.
+		[[nodiscard]] std::size_t getRetiredCount() const noexcept
+		{
+			return _retired_count.load(std::memory_order_relaxed);
+		}
+	};
+
+	inline void EpochParticipant::_pin() noexcept
+	{
+		if (_pin_depth++ != 0) return;
+
+		_epoch->store(_domain_epoch->load(std::memory_order_acquire), std::memory_order_relaxed);
+
+		// The pin has to be visible to advance() before this thread reads any shared pointer.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+
+	inline void EpochParticipant::_unpin() noexcept
+	{
+		if (--_pin_depth != 0) return;
+
+		_epoch->store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_release);
+	}
+
+	inline EpochGuard EpochParticipant::pin() noexcept
+	{
+		return EpochGuard(*this);
+	}
+}
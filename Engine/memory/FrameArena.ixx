@@ -0,0 +1,129 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module FrameArena;
+
+import std.compat;
+
+import Error;
+
+using namespace mt::error;
+
+export namespace mt::memory
+{
+	// Bump pointer allocator for memory that only has to live for a frame.
+	//
+	// There is one buffer per frame in flight. beginFrame(frame_index) rewinds that frame's buffer in O(1), so it must
+	// only be called once the frame that last used the buffer has retired. Deallocation of arena memory is a no-op.
+	// Requests that do not fit in the current buffer are served by the upstream resource and returned to it when
+	// deallocated, so containers never fail just because a frame ran long.
+	//
+	// Not thread safe, meant to be used from the tick thread.
+	class FrameArena : public std::pmr::memory_resource
+	{
+		static constexpr std::size_t _BUFFER_ALIGNMENT = std::hardware_destructive_interference_size;
+
+		std::size_t _frame_count;
+		std::size_t _bytes_per_frame;
+		std::size_t _buffer_stride = ((_bytes_per_frame + _BUFFER_ALIGNMENT - 1) / _BUFFER_ALIGNMENT) * _BUFFER_ALIGNMENT;
+
+		// Had to resort to malloc to get uninitialized memory. Not ideal, this is not modern cpp.
+		std::byte* _data = static_cast<std::byte*>(::malloc(_buffer_stride * _frame_count));
+
+		std::pmr::memory_resource* _upstream;
+
+		std::byte* _buffer = _data;
+		std::size_t _offset = 0;
+		std::size_t _high_water_mark = 0;
+		std::size_t _overflow_allocations = 0;
+
+		[[nodiscard]] bool _owns(const void* pointer) const noexcept
+		{
+			const auto* byte_pointer = static_cast<const std::byte*>(pointer);
+
+			return _data != nullptr && byte_pointer >= _data && byte_pointer < _data + _buffer_stride * _frame_count;
+		}
+
+	protected:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			if (_data != nullptr)
+			{
+				const auto address = reinterpret_cast<std::uintptr_t>(_buffer + _offset);
+				const auto padding = (alignment - address % alignment) % alignment;
+
+				if (padding + bytes <= _bytes_per_frame - _offset)
+				{
+					auto* pointer = _buffer + _offset + padding;
+
+					_offset += padding + bytes;
+					_high_water_mark = std::max(_high_water_mark, _offset);
+
+					return pointer;
+				}
+			}
+
+			++_overflow_allocations;
+
+			return _upstream->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override
+		{
+			// Arena memory is reclaimed all at once by beginFrame.
+			if (_owns(pointer)) return;
+
+			_upstream->deallocate(pointer, bytes, alignment);
+		}
+
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+
+	public:
+		FrameArena(
+			std::size_t frame_count,
+			std::size_t bytes_per_frame,
+			std::error_condition& error,
+			std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()
+		) noexcept
+			: _frame_count(std::max(frame_count, std::size_t{1}))
+			, _bytes_per_frame(bytes_per_frame)
+			, _upstream(upstream)
+		{
+			if (_data == nullptr)
+			{
+				Assign(error, mt::error::ErrorCode::BAD_ALLOCATION);
+			}
+		}
+
+		~FrameArena() noexcept override
+		{
+			::free(_data);
+		}
+
+		FrameArena(const FrameArena& other) noexcept = delete;
+		FrameArena(FrameArena&& other) noexcept = delete;
+		FrameArena& operator=(const FrameArena& other) noexcept = delete;
+		FrameArena& operator=(FrameArena&& other) noexcept = delete;
+
+		// Makes frame_index's buffer current and releases everything that was allocated from it.
+		void beginFrame(std::size_t frame_index) noexcept
+		{
+			_buffer = _data + _buffer_stride * (frame_index % _frame_count);
+			_offset = 0;
+		}
+
+		[[nodiscard]] std::size_t frameCount() const noexcept { return _frame_count; }
+
+		[[nodiscard]] std::size_t bytesPerFrame() const noexcept { return _bytes_per_frame; }
+
+		// Bytes handed out from the current buffer, including alignment padding.
+		[[nodiscard]] std::size_t bytesUsed() const noexcept { return _offset; }
+
+		// Most bytes any frame has used, a buffer that is always close to full should be made larger.
+		[[nodiscard]] std::size_t highWaterMark() const noexcept { return _high_water_mark; }
+
+		// Number of allocations that did not fit in their frame's buffer and went to the upstream resource.
+		[[nodiscard]] std::size_t overflowAllocations() const noexcept { return _overflow_allocations; }
+	};
+}
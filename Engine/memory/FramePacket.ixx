@@ -0,0 +1,70 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module FramePacket;
+
+import std;
+
+export namespace mt::memory
+{
+	// Hands a whole packet of per frame state from one thread to another without locks.
+	//
+	// The writer fills its packet in place and publishes it with a single atomic exchange, the reader picks up the
+	// newest published packet with another. Every packet the reader sees is complete and consistent, a packet that is
+	// published before the reader gets to it is replaced by the newer one. The writer and the reader each own one of
+	// three preallocated packets and the third is the one in flight, so neither side ever waits on the other.
+	//
+	// After publish() the writer gets back a packet with stale contents, every field has to be written again. Exactly
+	// one thread may write and one thread may read.
+	template<typename Packet> requires std::is_trivially_copyable_v<Packet> && std::default_initializable<Packet>
+	class FramePacketExchange
+	{
+		static constexpr std::size_t _CACHE_LINE = std::hardware_destructive_interference_size;
+		// Set on the packet in flight when it has been published and not read yet.
+		static constexpr std::uint8_t _IS_NEW = 0b100;
+		static constexpr std::uint8_t _INDEX_MASK = 0b011;
+
+		struct alignas(_CACHE_LINE) Buffer
+		{
+			Packet packet{};
+		};
+
+		std::array<Buffer, 3> _buffers{};
+
+		alignas(_CACHE_LINE) std::atomic<std::uint8_t> _in_flight = 1;
+
+		// Owned by the writer.
+		alignas(_CACHE_LINE) std::uint8_t _write = 0;
+
+		// Owned by the reader.
+		alignas(_CACHE_LINE) std::uint8_t _read = 2;
+
+	public:
+		FramePacketExchange() noexcept = default;
+		~FramePacketExchange() noexcept = default;
+		FramePacketExchange(const FramePacketExchange&) = delete;
+		FramePacketExchange(FramePacketExchange&&) = delete;
+		FramePacketExchange& operator=(const FramePacketExchange&) = delete;
+		FramePacketExchange& operator=(FramePacketExchange&&) = delete;
+
+		// Writer only.
+		[[nodiscard]] Packet& getWritePacket() noexcept { return _buffers[_write].packet; }
+
+		// Writer only. Makes the write packet the newest one and swaps in the packet that was in flight.
+		void publish() noexcept
+		{
+			_write = _in_flight.exchange(_write | _IS_NEW, std::memory_order_acq_rel) & _INDEX_MASK;
+		}
+
+		// Reader only. Picks up the newest packet if one was published since the last call, returns whether it did.
+		bool update() noexcept
+		{
+			if ((_in_flight.load(std::memory_order_relaxed) & _IS_NEW) == 0) return false;
+
+			_read = _in_flight.exchange(_read, std::memory_order_acq_rel) & _INDEX_MASK;
+
+			return true;
+		}
+
+		// Reader only. The packet picked up by the last update(), a default constructed Packet before the first one.
+		[[nodiscard]] const Packet& getReadPacket() const noexcept { return _buffers[_read].packet; }
+	};
+}
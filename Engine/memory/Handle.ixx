@@ -1,6 +1,23 @@
 export module Handle;
 
+import std;
+
 export namespace mt::memory
 {
 	using Handle = void*;
-}
\ No newline at end of file
+
+	// Generational handle into a SlotMap<T>. The generation of a slot is bumped every time its object is erased, so a
+	// handle that outlives its object stops resolving instead of aliasing whatever reuses the slot.
+	template<typename T>
+	struct SlotHandle
+	{
+		static constexpr std::uint32_t NULL_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+		std::uint32_t index = NULL_INDEX;
+		std::uint32_t generation = 0;
+
+		[[nodiscard]] constexpr bool isNull() const noexcept { return index == NULL_INDEX; }
+
+		constexpr auto operator<=>(const SlotHandle&) const noexcept = default;
+	};
+}
@@ -0,0 +1,327 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module LockFreeObjectPool;
+
+import std.compat;
+
+import BackingStore;
+import Error;
+import MemoryTracking;
+import TaggedIndexStack;
+
+using namespace mt::error;
+
+namespace mt::memory
+{
+	// Small dense id for the calling thread, used to pick a per thread magazine. The id of a thread that exits is
+	// handed to the next thread that asks, so ids stay small and the slots cached under an id are picked back up.
+	class ThreadIndex
+	{
+		struct Registry
+		{
+			std::mutex lock;
+			std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<>> free_indices;
+			std::size_t next_index = 0;
+		};
+
+		static Registry& _getRegistry() noexcept
+		{
+			static Registry registry;
+			return registry;
+		}
+
+		std::size_t _index;
+
+	public:
+		ThreadIndex() noexcept
+		{
+			auto& registry = _getRegistry();
+			std::scoped_lock lock(registry.lock);
+
+			if (registry.free_indices.empty())
+			{
+				_index = registry.next_index++;
+			}
+			else
+			{
+				_index = registry.free_indices.top();
+				registry.free_indices.pop();
+			}
+		}
+
+		~ThreadIndex() noexcept
+		{
+			auto& registry = _getRegistry();
+			std::scoped_lock lock(registry.lock);
+			registry.free_indices.push(_index);
+		}
+
+		ThreadIndex(const ThreadIndex&) = delete;
+		ThreadIndex(ThreadIndex&&) = delete;
+		ThreadIndex& operator=(const ThreadIndex&) = delete;
+		ThreadIndex& operator=(ThreadIndex&&) = delete;
+
+		[[nodiscard]] std::size_t get() const noexcept { return _index; }
+	};
+
+	std::size_t currentThreadIndex() noexcept
+	{
+		thread_local const ThreadIndex thread_index;
+		return thread_index.get();
+	}
+}
+
+export namespace mt::memory
+{
+	struct MagazineStatistics
+	{
+		// Number of times a thread found its magazine empty and took a batch from the shared free list.
+		std::size_t refills;
+		// Number of times a thread found its magazine full and returned a batch to the shared free list.
+		std::size_t flushes;
+	};
+
+	// Fixed capacity pool whose allocate and release never take a lock.
+	//
+	// Free slots form a TaggedIndexStack, a Treiber stack whose head carries an ABA tag.
+	//
+	// When magazine_size is non-zero each thread keeps up to magazine_size free slots of its own. Allocations are
+	// served from, and releases returned to, the calling thread's magazine, which is refilled and flushed in batches,
+	// so most calls never touch the shared stack. Slots parked in one thread's magazine are not available to other
+	// threads, so up to magazine_size slots per thread can be unavailable before size() reaches capacity().
+	//
+	// BackingStore picks where the slots come from, see BackingStore.ixx.
+	template<
+		typename T,
+		std::size_t pool_capacity,
+		std::size_t magazine_size = 0,
+		BackingStorePolicy BackingStore = MallocBackingStore
+	>
+	class LockFreeObjectPool
+	{
+		static_assert(pool_capacity < std::numeric_limits<std::uint32_t>::max(), "Slot indices are 32 bits.");
+		static_assert(magazine_size <= pool_capacity, "A magazine can not hold more than the pool.");
+
+	public:
+		class Deleter
+		{
+			LockFreeObjectPool<T, pool_capacity, magazine_size, BackingStore>& _object_pool;
+
+		public:
+			Deleter(LockFreeObjectPool<T, pool_capacity, magazine_size, BackingStore>& object_pool)
+				: _object_pool(object_pool)
+			{}
+
+			void operator()(T const * pointer)
+			{
+				if (pointer) {
+					if (auto expected = _object_pool.releaseMemory(pointer); !expected) return;
+				}
+			}
+		};
+
+	private:
+		static constexpr std::uint32_t _NO_SLOT = TaggedIndexStack::NO_INDEX;
+
+		static constexpr std::size_t _RESERVED_BYTES =
+			sizeof(T) * pool_capacity + TaggedIndexStack::getReservedBytes(pool_capacity);
+
+		// Threads past this many fall back to the shared stack.
+		static constexpr std::size_t _MAX_MAGAZINES = magazine_size > 0 ? 16 : 0;
+
+		// Written only by the owning thread, read by anyone asking for size() or statistics.
+		struct alignas(std::hardware_destructive_interference_size) Magazine
+		{
+			std::size_t count = 0;
+			std::array<std::uint32_t, magazine_size> slots{};
+
+			std::atomic<std::size_t> allocations = 0;
+			std::atomic<std::size_t> releases = 0;
+			std::atomic<std::size_t> refills = 0;
+			std::atomic<std::size_t> flushes = 0;
+
+			static void increment(std::atomic<std::size_t>& counter) noexcept
+			{
+				counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			}
+		};
+
+		T*														_data = static_cast<T*>(
+			BackingStore::allocate(sizeof(T) * pool_capacity)
+		);
+		const std::size_t _capacity = pool_capacity;
+		Deleter deleter {*this};
+		MemoryTag _memory_tag;
+
+		// Its head is written by every thread and sits on a cache line of its own.
+		TaggedIndexStack _free_slots{pool_capacity};
+		alignas(std::hardware_destructive_interference_size) std::atomic<std::size_t> _size{0};
+
+		std::array<Magazine, _MAX_MAGAZINES> _magazines{};
+
+		[[nodiscard]] Magazine* _getMagazine() noexcept
+		{
+			if constexpr (_MAX_MAGAZINES == 0)
+			{
+				return nullptr;
+			}
+			else
+			{
+				const auto thread_index = currentThreadIndex();
+				return thread_index < _MAX_MAGAZINES ? &_magazines[thread_index] : nullptr;
+			}
+		}
+
+		[[nodiscard]] std::uint32_t _acquireSlot() noexcept
+		{
+			if (auto magazine = _getMagazine(); magazine)
+			{
+				if (magazine->count == 0)
+				{
+					magazine->count = _free_slots.popChain(magazine->slots);
+
+					if (magazine->count == 0) return _NO_SLOT;
+
+					Magazine::increment(magazine->refills);
+				}
+
+				Magazine::increment(magazine->allocations);
+
+				return magazine->slots[--magazine->count];
+			}
+
+			const auto index = _free_slots.pop();
+
+			if (index == _NO_SLOT) return _NO_SLOT;
+
+			_size.fetch_add(1, std::memory_order_relaxed);
+
+			return index;
+		}
+
+		void _returnSlot(std::uint32_t index) noexcept
+		{
+			if (auto magazine = _getMagazine(); magazine)
+			{
+				if (magazine->count == magazine_size)
+				{
+					// Hand back the oldest slots, the most recently released ones are the most likely to still be cached.
+					const auto kept = magazine_size / 2;
+					const auto flushed = magazine_size - kept;
+
+					_free_slots.pushChain(
+						std::span<const std::uint32_t>(magazine->slots.data(), flushed)
+					);
+					std::copy(magazine->slots.begin() + flushed, magazine->slots.end(), magazine->slots.begin());
+					magazine->count = kept;
+
+					Magazine::increment(magazine->flushes);
+				}
+
+				magazine->slots[magazine->count++] = index;
+
+				Magazine::increment(magazine->releases);
+
+				return;
+			}
+
+			_free_slots.push(index);
+
+			_size.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] bool releaseMemory(T const * returned_memory)
+		{
+			// Check if we actually own this object.
+			if (returned_memory == nullptr || returned_memory < _data || returned_memory >= _data + _capacity)
+			{
+				return false;
+			}
+
+			returned_memory->~T();
+
+			_returnSlot(static_cast<std::uint32_t>(returned_memory - _data));
+
+			return true;
+		}
+
+	public:
+		friend LockFreeObjectPool::Deleter;
+
+		// Only the backing storage is charged to the tag, counting every allocation would put a shared cache line back
+		// on the path the magazines keep thread local.
+		LockFreeObjectPool(std::error_condition& error, MemoryTag tag = MemoryTag::UNTAGGED) noexcept
+			: _memory_tag(tag)
+		{
+			if (_data == nullptr || !_free_slots.isValid())
+			{
+				Assign(error, mt::error::ErrorCode::BAD_ALLOCATION);
+			}
+			else
+			{
+				MemoryTracker::global().recordReserve(_memory_tag, _RESERVED_BYTES);
+
+				_free_slots.fill(static_cast<std::uint32_t>(pool_capacity));
+			}
+		}
+
+		// Every unique_ptr_t holds a reference to this pool, so all of them must have been released by now.
+		~LockFreeObjectPool() noexcept
+		{
+			if (_data != nullptr && _free_slots.isValid())
+			{
+				MemoryTracker::global().recordUnreserve(_memory_tag, _RESERVED_BYTES);
+			}
+
+			BackingStore::deallocate(_data);
+		};
+
+		LockFreeObjectPool(const LockFreeObjectPool& other) noexcept = delete;
+		LockFreeObjectPool(LockFreeObjectPool&& other) noexcept = delete;
+		LockFreeObjectPool& operator=(const LockFreeObjectPool& other) noexcept = delete;
+		LockFreeObjectPool& operator=(LockFreeObjectPool&& other) noexcept = delete;
+
+		// Approximate while other threads are allocating or releasing.
+		[[nodiscard]] std::size_t size() const noexcept
+		{
+			// Objects may be allocated on one thread and released on another, the unsigned sums wrap back around.
+			auto size = _size.load(std::memory_order_relaxed);
+
+			for (const auto& magazine : _magazines)
+			{
+				size += magazine.allocations.load(std::memory_order_relaxed);
+				size -= magazine.releases.load(std::memory_order_relaxed);
+			}
+
+			return size;
+		}
+
+		[[nodiscard]] constexpr std::size_t capacity() noexcept { return pool_capacity; }
+
+		[[nodiscard]] static constexpr std::size_t magazineCapacity() noexcept { return magazine_size; }
+
+		[[nodiscard]] MagazineStatistics getMagazineStatistics() const noexcept
+		{
+			MagazineStatistics statistics{0, 0};
+
+			for (const auto& magazine : _magazines)
+			{
+				statistics.refills += magazine.refills.load(std::memory_order_relaxed);
+				statistics.flushes += magazine.flushes.load(std::memory_order_relaxed);
+			}
+
+			return statistics;
+		}
+
+		using unique_ptr_t = std::unique_ptr<T, Deleter>;
+
+		template<class... Types>
+		unique_ptr_t allocate(Types&&... args)
+		{
+			const auto index = _acquireSlot();
+
+			if (index == _NO_SLOT) return unique_ptr_t{nullptr, deleter};
+
+			return unique_ptr_t(new (&_data[index]) T(std::forward<Types>(args)...), deleter);
+		}
+	};
+}
@@ -2,6 +2,8 @@ export module MakeUnique;
 
 import std;
 
+import MemoryTracking;
+
 export namespace mt::memory
 {
 	template <typename T, typename... Args>
@@ -9,4 +11,36 @@ export namespace mt::memory
 	{
 		return std::unique_ptr<T>(new (std::nothrow) T(std::forward<Args>(args)...));
 	}
-}
\ No newline at end of file
+
+	// Remembers the tag and size of the most derived type, so a tracked_unique_ptr to a base still frees the right amount.
+	struct TrackedDeleter
+	{
+		MemoryTag tag = MemoryTag::UNTAGGED;
+		std::size_t bytes = 0;
+
+		template <typename T>
+		void operator()(T* pointer) const noexcept
+		{
+			if (pointer)
+			{
+				delete pointer;
+
+				MemoryTracker::global().recordFree(tag, bytes);
+			}
+		}
+	};
+
+	template <typename T>
+	using tracked_unique_ptr = std::unique_ptr<T, TrackedDeleter>;
+
+	// make_unique_nothrow that charges the object to a subsystem in the global MemoryTracker.
+	template <typename T, typename... Args>
+	tracked_unique_ptr<T> make_tracked_unique_nothrow(MemoryTag tag, Args&&... args) noexcept
+	{
+		auto pointer = new (std::nothrow) T(std::forward<Args>(args)...);
+
+		if (pointer) MemoryTracker::global().recordAllocation(tag, sizeof(T));
+
+		return tracked_unique_ptr<T>(pointer, TrackedDeleter{tag, sizeof(T)});
+	}
+}
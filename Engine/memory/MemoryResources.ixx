@@ -0,0 +1,44 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module MemoryResources;
+
+import std;
+
+export import MemoryTracking;
+
+export namespace mt::memory
+{
+	// The memory resource each engine subsystem builds its long lived containers from, handed to the Engine when it
+	// is constructed. Startup only data can come from a monotonic buffer, long lived maps from a pool, and so on.
+	// The resources must outlive the Engine. Anything left alone uses the default resource.
+	struct MemoryResources
+	{
+		std::pmr::memory_resource* input = std::pmr::get_default_resource();
+		std::pmr::memory_resource* time = std::pmr::get_default_resource();
+		std::pmr::memory_resource* event = std::pmr::get_default_resource();
+		std::pmr::memory_resource* renderer = std::pmr::get_default_resource();
+		std::pmr::memory_resource* geometry = std::pmr::get_default_resource();
+	};
+
+	// Wraps each of a MemoryResources in a TrackingMemoryResource charged to its subsystem's tag.
+	struct TrackingMemoryResources
+	{
+		TrackingMemoryResource input;
+		TrackingMemoryResource time;
+		TrackingMemoryResource event;
+		TrackingMemoryResource renderer;
+		TrackingMemoryResource geometry;
+
+		explicit TrackingMemoryResources(const MemoryResources& upstream) noexcept
+			: input(MemoryTag::INPUT, upstream.input)
+			, time(MemoryTag::TIME, upstream.time)
+			, event(MemoryTag::EVENT, upstream.event)
+			, renderer(MemoryTag::RENDERER, upstream.renderer)
+			, geometry(MemoryTag::GEOMETRY, upstream.geometry)
+		{}
+
+		[[nodiscard]] MemoryResources getMemoryResources() noexcept
+		{
+			return MemoryResources{&input, &time, &event, &renderer, &geometry};
+		}
+	};
+}
@@ -0,0 +1,248 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module MemoryTracking;
+
+import std;
+
+export namespace mt::memory
+{
+	// The subsystem a piece of memory is charged to.
+	enum class MemoryTag : std::uint8_t
+	{
+		UNTAGGED,
+		INPUT,
+		TIME,
+		EVENT,
+		RENDERER,
+		GEOMETRY,
+		WINDOWS,
+		COUNT
+	};
+
+	constexpr std::size_t MEMORY_TAG_COUNT = static_cast<std::size_t>(MemoryTag::COUNT);
+
+	[[nodiscard]] constexpr std::wstring_view toWString(MemoryTag tag) noexcept
+	{
+		switch (tag)
+		{
+			case MemoryTag::INPUT:		return L"input";
+			case MemoryTag::TIME:		return L"time";
+			case MemoryTag::EVENT:		return L"event";
+			case MemoryTag::RENDERER:	return L"renderer";
+			case MemoryTag::GEOMETRY:	return L"geometry";
+			case MemoryTag::WINDOWS:	return L"windows";
+			default:					return L"untagged";
+		}
+	}
+
+	struct MemoryTagStatistics
+	{
+		MemoryTag tag;
+		// Bytes of individual allocations that have not been freed yet.
+		std::size_t live_bytes;
+		std::size_t peak_bytes;
+		// Bytes held up front by pools, whether or not any objects live in them.
+		std::size_t reserved_bytes;
+		std::size_t allocations;
+		std::size_t frees;
+		// Allocations and frees made during the last frame passed to endFrame().
+		std::size_t allocations_per_frame;
+		std::size_t frees_per_frame;
+	};
+
+	// Live, peak and per frame allocation counters for every MemoryTag.
+	//
+	// The counters are relaxed atomics, each tag on its own cache line, so recording costs one uncontended atomic add
+	// and is cheap enough to leave on in release builds. Any thread can record, endFrame() is meant to be called once
+	// a frame from the tick thread. A snapshot taken while other threads are recording is approximate.
+	class MemoryTracker
+	{
+		struct alignas(std::hardware_destructive_interference_size) Counters
+		{
+			std::atomic<std::size_t> live_bytes = 0;
+			std::atomic<std::size_t> peak_bytes = 0;
+			std::atomic<std::size_t> reserved_bytes = 0;
+			std::atomic<std::size_t> allocations = 0;
+			std::atomic<std::size_t> frees = 0;
+
+			// Written by endFrame().
+			std::atomic<std::size_t> allocations_at_frame_start = 0;
+			std::atomic<std::size_t> frees_at_frame_start = 0;
+			std::atomic<std::size_t> allocations_per_frame = 0;
+			std::atomic<std::size_t> frees_per_frame = 0;
+		};
+
+		std::array<Counters, MEMORY_TAG_COUNT> _counters{};
+
+		[[nodiscard]] Counters& _getCounters(MemoryTag tag) noexcept
+		{
+			return _counters[std::min(static_cast<std::size_t>(tag), MEMORY_TAG_COUNT - 1)];
+		}
+
+	public:
+		MemoryTracker() noexcept = default;
+		~MemoryTracker() noexcept = default;
+		MemoryTracker(const MemoryTracker&) = delete;
+		MemoryTracker(MemoryTracker&&) = delete;
+		MemoryTracker& operator=(const MemoryTracker&) = delete;
+		MemoryTracker& operator=(MemoryTracker&&) = delete;
+
+		// The tracker the engine's pools, resources and make_tracked_unique_nothrow record to.
+		[[nodiscard]] static MemoryTracker& global() noexcept
+		{
+			static MemoryTracker tracker;
+			return tracker;
+		}
+
+		// Records count allocations totalling bytes at once, so a batch costs the same as a single allocation.
+		void recordAllocation(MemoryTag tag, std::size_t bytes, std::size_t count = 1) noexcept
+		{
+			if (count == 0) return;
+
+			auto& counters = _getCounters(tag);
+
+			counters.allocations.fetch_add(count, std::memory_order_relaxed);
+
+			const auto live_bytes = counters.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+			auto peak_bytes = counters.peak_bytes.load(std::memory_order_relaxed);
+			while (peak_bytes < live_bytes && !counters.peak_bytes.compare_exchange_weak(
+				peak_bytes, live_bytes, std::memory_order_relaxed
+			));
+		}
+
+		void recordFree(MemoryTag tag, std::size_t bytes, std::size_t count = 1) noexcept
+		{
+			if (count == 0) return;
+
+			auto& counters = _getCounters(tag);
+
+			counters.frees.fetch_add(count, std::memory_order_relaxed);
+			counters.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+		}
+
+		void recordReserve(MemoryTag tag, std::size_t bytes) noexcept
+		{
+			_getCounters(tag).reserved_bytes.fetch_add(bytes, std::memory_order_relaxed);
+		}
+
+		void recordUnreserve(MemoryTag tag, std::size_t bytes) noexcept
+		{
+			_getCounters(tag).reserved_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+		}
+
+		// Closes the current frame, its allocation and free counts become the per frame counts.
+		void endFrame() noexcept
+		{
+			for (auto& counters : _counters)
+			{
+				const auto allocations = counters.allocations.load(std::memory_order_relaxed);
+				const auto frees = counters.frees.load(std::memory_order_relaxed);
+
+				counters.allocations_per_frame.store(
+					allocations - counters.allocations_at_frame_start.load(std::memory_order_relaxed),
+					std::memory_order_relaxed
+				);
+				counters.frees_per_frame.store(
+					frees - counters.frees_at_frame_start.load(std::memory_order_relaxed),
+					std::memory_order_relaxed
+				);
+
+				counters.allocations_at_frame_start.store(allocations, std::memory_order_relaxed);
+				counters.frees_at_frame_start.store(frees, std::memory_order_relaxed);
+			}
+		}
+
+		[[nodiscard]] MemoryTagStatistics getStatistics(MemoryTag tag) noexcept
+		{
+			auto& counters = _getCounters(tag);
+
+			return MemoryTagStatistics{
+				tag,
+				counters.live_bytes.load(std::memory_order_relaxed),
+				counters.peak_bytes.load(std::memory_order_relaxed),
+				counters.reserved_bytes.load(std::memory_order_relaxed),
+				counters.allocations.load(std::memory_order_relaxed),
+				counters.frees.load(std::memory_order_relaxed),
+				counters.allocations_per_frame.load(std::memory_order_relaxed),
+				counters.frees_per_frame.load(std::memory_order_relaxed)
+			};
+		}
+
+		// One line per tag that has ever held memory, suitable for OutputDebugString.
+		[[nodiscard]] std::wstring getReport() noexcept
+		{
+			std::wstring report;
+
+			for (auto index = std::size_t{0}; index < MEMORY_TAG_COUNT; ++index)
+			{
+				const auto statistics = getStatistics(static_cast<MemoryTag>(index));
+
+				if (statistics.allocations == 0 && statistics.reserved_bytes == 0) continue;
+
+				report += std::format(
+					L"{} : {} live bytes : {} peak bytes : {} reserved bytes : {} allocations/frame : {} frees/frame\n",
+					toWString(statistics.tag),
+					statistics.live_bytes,
+					statistics.peak_bytes,
+					statistics.reserved_bytes,
+					statistics.allocations_per_frame,
+					statistics.frees_per_frame
+				);
+			}
+
+			return report;
+		}
+	};
+
+	// Forwards to an upstream resource and charges everything allocated through it to a tag.
+	class TrackingMemoryResource : public std::pmr::memory_resource
+	{
+		MemoryTag _tag;
+		std::pmr::memory_resource* _upstream;
+		MemoryTracker* _tracker;
+
+	protected:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			auto pointer = _upstream->allocate(bytes, alignment);
+
+			_tracker->recordAllocation(_tag, bytes);
+
+			return pointer;
+		}
+
+		void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override
+		{
+			_upstream->deallocate(pointer, bytes, alignment);
+
+			_tracker->recordFree(_tag, bytes);
+		}
+
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+
+	public:
+		TrackingMemoryResource(
+			MemoryTag tag,
+			std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+			MemoryTracker* tracker = &MemoryTracker::global()
+		) noexcept
+			: _tag(tag)
+			, _upstream(upstream)
+			, _tracker(tracker)
+		{}
+
+		~TrackingMemoryResource() noexcept override = default;
+
+		TrackingMemoryResource(const TrackingMemoryResource& other) noexcept = delete;
+		TrackingMemoryResource(TrackingMemoryResource&& other) noexcept = delete;
+		TrackingMemoryResource& operator=(const TrackingMemoryResource& other) noexcept = delete;
+		TrackingMemoryResource& operator=(TrackingMemoryResource&& other) noexcept = delete;
+
+		[[nodiscard]] MemoryTag tag() const noexcept { return _tag; }
+
+		[[nodiscard]] std::pmr::memory_resource* upstream() const noexcept { return _upstream; }
+	};
+}
@@ -3,99 +3,314 @@ export module ObjectPool;
 
 import std.compat;
 
+import BackingStore;
 import Error;
 import MakeUnique;
+import MemoryTracking;
+import TaggedIndexStack;
+import ThreadingPolicy;
 
 using namespace mt::error;
 
 export namespace mt::memory
 {
-	template<typename T, std::size_t pool_capacity>
+	// Fixed capacity pool of T.
+	//
+	// ThreadingPolicy picks how the pool is synchronized, see ThreadingPolicy.ixx. A SingleThreadedPolicy pool takes
+	// no locks and keeps its free list inside the free slots, so it makes no allocations besides the slots
+	// themselves. A LockFreePolicy pool keeps the free list in a TaggedIndexStack, like LockFreeObjectPool without
+	// the magazines, which needs a side array of links.
+	//
+	// BackingStore picks where the slots come from, see BackingStore.ixx. Long lived pools that are allocated from
+	// mid frame should use a prefaulted store so the first touch of each page does not fault.
+	template<
+		typename T,
+		std::size_t pool_capacity,
+		ThreadingPolicyType ThreadingPolicy = MutexPolicy,
+		BackingStorePolicy BackingStore = MallocBackingStore
+	>
 	class ObjectPool
 	{
+		static_assert(pool_capacity < std::numeric_limits<std::uint32_t>::max(), "Slot indices are 32 bits.");
+
 	public:
+		// Default constructible so that unique_ptr_t is, which lets allocate_n fill a span of empty pointers.
 		class Deleter
 		{
-			ObjectPool<T, pool_capacity>& _object_pool;
+			ObjectPool* _object_pool = nullptr;
 
 		public:
-			Deleter(ObjectPool<T, pool_capacity>& object_pool)
-				: _object_pool(object_pool)
+			Deleter() noexcept = default;
+
+			Deleter(ObjectPool& object_pool)
+				: _object_pool(&object_pool)
 			{}
 
 			void operator()(T const * pointer)
 			{
-				if (pointer) {
-					if (auto expected = _object_pool.releaseMemory(pointer); !expected) return;
+				if (pointer && _object_pool) {
+					if (auto expected = _object_pool->releaseMemory(pointer); !expected) return;
 				}
 			}
+
+			[[nodiscard]] bool isFrom(const ObjectPool& object_pool) const noexcept
+			{
+				return _object_pool == &object_pool;
+			}
 		};
 
 	private:
-		// Had to resort to malloc to get uninitialized memory. Not ideal, this is not modern cpp.
-		T*															_data = (T*)::malloc(sizeof(T) * pool_capacity);
-		std::priority_queue<int, std::vector<int>, std::greater<>> 	unused_indices;
-		std::set<int>												_used_indices;
-		const std::size_t _capacity = pool_capacity;
+		static constexpr bool _IS_LOCK_FREE = ThreadingPolicy::IS_LOCK_FREE;
+		static constexpr std::uint32_t _NO_SLOT = TaggedIndexStack::NO_INDEX;
+		static constexpr std::size_t _OCCUPANCY_WORDS = (pool_capacity + 63) / 64;
+
+		// A free slot holds the index of the next free slot.
+		union Slot
+		{
+			std::uint32_t next;
+			alignas(T) std::byte object[sizeof(T)];
+		};
+
+		static constexpr std::size_t _RESERVED_BYTES =
+			sizeof(Slot) * pool_capacity + (_IS_LOCK_FREE ? TaggedIndexStack::getReservedBytes(pool_capacity) : 0);
+
+		Slot* _slots = static_cast<Slot*>(BackingStore::allocate(sizeof(Slot) * pool_capacity));
+
+		// Index of the first free slot, or the whole free list when lock free. A lock free pool can not link through
+		// the slots.
+		std::conditional_t<_IS_LOCK_FREE, TaggedIndexStack, std::uint32_t> _free_head;
+
+		// One bit per slot, set while the slot holds a live object. Scanned a word at a time to visit live objects.
+		std::array<std::uint64_t, _OCCUPANCY_WORDS> _occupancy{};
+		std::conditional_t<ThreadingPolicy::IS_THREAD_SAFE, std::atomic<std::size_t>, std::size_t> _size{0};
+
 		Deleter deleter {*this};
-		std::mutex mutex;
+		typename ThreadingPolicy::mutex_type mutex;
+		MemoryTag _memory_tag;
 
-		[[nodiscard]] bool releaseMemory(T const * returned_memory)
+		[[nodiscard]] T* _object(std::uint32_t index) noexcept
 		{
-			std::scoped_lock lock(mutex);
+			return std::launder(reinterpret_cast<T*>(_slots[index].object));
+		}
+
+		// When not lock free these must be called holding the mutex.
 
-			// Check if we actually own this object.
-			int index = static_cast<int>(returned_memory - _data);
-			if (returned_memory == nullptr || index < 0 || index >= _capacity)
+		[[nodiscard]] std::uint32_t _pop() noexcept
+		{
+			if constexpr (_IS_LOCK_FREE)
 			{
-				return false;
+				return _free_head.pop();
+			}
+			else
+			{
+				const auto index = _free_head;
+
+				if (index != _NO_SLOT) _free_head = _slots[index].next;
+
+				return index;
+			}
+		}
+
+		void _push(std::uint32_t index) noexcept
+		{
+			if constexpr (_IS_LOCK_FREE)
+			{
+				_free_head.push(index);
+			}
+			else
+			{
+				_slots[index].next = _free_head;
+				_free_head = index;
+			}
+		}
+
+		void _setOccupied(std::uint32_t index) noexcept
+		{
+			const auto bit = std::uint64_t{1} << (index % 64);
+
+			if constexpr (_IS_LOCK_FREE)
+			{
+				std::atomic_ref(_occupancy[index / 64]).fetch_or(bit, std::memory_order_relaxed);
+				_size.fetch_add(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				_occupancy[index / 64] |= bit;
+
+				if constexpr (ThreadingPolicy::IS_THREAD_SAFE) _size.fetch_add(1, std::memory_order_relaxed);
+				else ++_size;
+			}
+		}
+
+		void _clearOccupied(std::uint32_t index) noexcept
+		{
+			const auto bit = std::uint64_t{1} << (index % 64);
+
+			if constexpr (_IS_LOCK_FREE)
+			{
+				std::atomic_ref(_occupancy[index / 64]).fetch_and(~bit, std::memory_order_relaxed);
+				_size.fetch_sub(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				_occupancy[index / 64] &= ~bit;
+
+				if constexpr (ThreadingPolicy::IS_THREAD_SAFE) _size.fetch_sub(1, std::memory_order_relaxed);
+				else --_size;
 			}
-			else {
-				returned_memory->~T();
+		}
 
-				//if (mt::IS_DEBUG) std::memset_s(returned_memory, sizeof(T), 0, sizeof(T));
+		[[nodiscard]] std::uint64_t _loadOccupancy(std::size_t word_index) noexcept
+		{
+			if constexpr (_IS_LOCK_FREE)
+				return std::atomic_ref(_occupancy[word_index]).load(std::memory_order_relaxed);
+			else
+				return _occupancy[word_index];
+		}
 
-				_used_indices.erase(index);
+		// Calls function with the index of every occupied slot, lowest first. Runs of four empty words, 256 slots, are
+		// skipped with a single test.
+		template<typename Function>
+		void _forEachOccupied(Function&& function) noexcept
+		{
+			constexpr std::size_t STRIDE = 4;
 
-				unused_indices.push(index);
+			for (auto first_word = std::size_t{0}; first_word < _OCCUPANCY_WORDS; first_word += STRIDE)
+			{
+				const auto last_word = std::min(first_word + STRIDE, _OCCUPANCY_WORDS);
 
-				return true;
+				std::array<std::uint64_t, STRIDE> words{};
+				std::uint64_t any = 0;
+				for (auto word_index = first_word; word_index < last_word; ++word_index)
+				{
+					words[word_index - first_word] = _loadOccupancy(word_index);
+					any |= words[word_index - first_word];
+				}
+
+				if (any == 0) continue;
+
+				for (auto word_index = first_word; word_index < last_word; ++word_index)
+				{
+					for (auto word = words[word_index - first_word]; word != 0; word &= word - 1)
+					{
+						function(static_cast<std::uint32_t>(word_index * 64 + std::countr_zero(word)));
+					}
+				}
 			}
 		}
 
+		template<class... Types>
+		[[nodiscard]] T* _construct(Types&&... args)
+		{
+			const auto index = _pop();
+
+			if (index == _NO_SLOT) return nullptr;
+
+			_setOccupied(index);
+
+			return new (_slots[index].object) T(std::forward<Types>(args)...);
+		}
+
+		[[nodiscard]] bool _destroy(T const * returned_memory) noexcept
+		{
+			const auto offset =
+				reinterpret_cast<std::uintptr_t>(returned_memory) - reinterpret_cast<std::uintptr_t>(_slots);
+
+			// Check if we actually own this object, pointers below the slots wrap around to huge offsets.
+			if (returned_memory == nullptr || offset >= sizeof(Slot) * pool_capacity || offset % sizeof(Slot) != 0)
+			{
+				return false;
+			}
+
+			const auto index = static_cast<std::uint32_t>(offset / sizeof(Slot));
+
+			returned_memory->~T();
+
+			//if (mt::IS_DEBUG) std::memset_s(returned_memory, sizeof(T), 0, sizeof(T));
+
+			_clearOccupied(index);
+
+			_push(index);
+
+			return true;
+		}
+
+		[[nodiscard]] bool releaseMemory(T const * returned_memory)
+		{
+			std::scoped_lock lock(mutex);
+
+			if (!_destroy(returned_memory)) return false;
+
+			MemoryTracker::global().recordFree(_memory_tag, sizeof(T));
+
+			return true;
+		}
+
 	public:
 		friend ObjectPool::Deleter;
-		friend std::unique_ptr<ObjectPool<T,pool_capacity>> mt::memory::make_unique_nothrow(Error&& error) noexcept;
+		friend std::unique_ptr<ObjectPool> mt::memory::make_unique_nothrow(Error&& error) noexcept;
 
-		ObjectPool(std::error_condition& error) noexcept
+		ObjectPool(std::error_condition& error, MemoryTag tag = MemoryTag::UNTAGGED) noexcept
+			// An empty free list either way, the stack allocates its links up front.
+			: _free_head(_IS_LOCK_FREE ? pool_capacity : _NO_SLOT)
+			, _memory_tag(tag)
 		{
-			if (_data == nullptr)
+			bool is_valid = _slots != nullptr;
+
+			if constexpr (_IS_LOCK_FREE) is_valid = is_valid && _free_head.isValid();
+
+			if (!is_valid)
 			{
 				Assign(error, mt::error::ErrorCode::BAD_ALLOCATION);
 			}
 			else
 			{
-				for (auto i = 0; i < _capacity; i++)
+				MemoryTracker::global().recordReserve(_memory_tag, _RESERVED_BYTES);
+
+				// Link every slot in ascending order so the first allocations are the lowest addresses.
+				if constexpr (_IS_LOCK_FREE)
 				{
-					unused_indices.push(i);
+					_free_head.fill(static_cast<std::uint32_t>(pool_capacity));
+				}
+				else
+				{
+					for (std::uint32_t i = 0; i < pool_capacity; i++)
+					{
+						_slots[i].next = i + 1 < pool_capacity ? i + 1 : _NO_SLOT;
+					}
+
+					_free_head = 0;
 				}
 			}
 		}
 
+		// Every unique_ptr_t holds a pointer to this pool, so all of them should have been released by now. Objects
+		// whose ownership was given up with unique_ptr::release are still live and are destroyed here.
 		~ObjectPool() noexcept
 		{
-			for (auto index = unused_indices.top(); !unused_indices.empty(); unused_indices.pop())
-			{
-				_data[index].~T();
-			}
+			if (_slots == nullptr) return;
+
+			reset();
+
+			MemoryTracker::global().recordUnreserve(_memory_tag, _RESERVED_BYTES);
+
+			BackingStore::deallocate(_slots);
 		};
 
 		ObjectPool(const ObjectPool& other) noexcept = delete;
-		ObjectPool(ObjectPool&& other) noexcept = default;
+		ObjectPool(ObjectPool&& other) noexcept = delete;
 		ObjectPool& operator=(const ObjectPool& other) noexcept = delete;
-		ObjectPool& operator=(ObjectPool&& other) noexcept = default;
+		ObjectPool& operator=(ObjectPool&& other) noexcept = delete;
+
+		// Approximate while other threads are allocating or releasing.
+		[[nodiscard]] std::size_t size() const noexcept
+		{
+			if constexpr (ThreadingPolicy::IS_THREAD_SAFE)
+				return _size.load(std::memory_order_relaxed);
+			else
+				return _size;
+		}
 
-		[[nodiscard]] std::size_t size() const noexcept { return _used_indices.size(); }
 		[[nodiscard]] constexpr std::size_t capacity() noexcept { return pool_capacity; }
 
 		using unique_ptr_t = std::unique_ptr<T, Deleter>;
@@ -105,18 +320,110 @@ export namespace mt::memory
 		{
 			std::scoped_lock lock(mutex);
 
-			if (unused_indices.empty()) return unique_ptr_t{nullptr, deleter};
+			auto pointer = _construct(std::forward<Types>(args)...);
 
-			auto index = unused_indices.top();
+			if (pointer) MemoryTracker::global().recordAllocation(_memory_tag, sizeof(T));
 
-			unused_indices.pop();
+			return unique_ptr_t(pointer, deleter);
+		}
 
-			_used_indices.insert(index);
+		// Fills objects with up to objects.size() new objects, each constructed from args, under a single lock.
+		// Anything objects already own is released first. Returns how many were allocated, fewer than objects.size()
+		// only when the pool runs out, in which case the remaining entries are left empty.
+		template<class... Types>
+		std::size_t allocate_n(std::span<unique_ptr_t> objects, const Types&... args)
+		{
+			for (auto& object : objects) object.reset();
+
+			std::scoped_lock lock(mutex);
+
+			std::size_t count = 0;
+			for (; count < objects.size(); ++count)
+			{
+				auto pointer = _construct(args...);
 
-			return unique_ptr_t(new (&_data[index]) T(std::forward<Types>(args)...), deleter);
+				if (pointer == nullptr) break;
+
+				objects[count] = unique_ptr_t(pointer, deleter);
+			}
+
+			MemoryTracker::global().recordAllocation(_memory_tag, sizeof(T) * count, count);
+
+			return count;
+		}
+
+		// Destroys and returns every object in objects that came from this pool under a single lock, leaving its entry
+		// empty. Entries from other pools are left untouched. Returns how many were released.
+		std::size_t release_n(std::span<unique_ptr_t> objects) noexcept
+		{
+			std::scoped_lock lock(mutex);
+
+			std::size_t count = 0;
+			for (auto& object : objects)
+			{
+				if (!object || !object.get_deleter().isFrom(*this)) continue;
+
+				if (_destroy(object.get()))
+				{
+					// Already destroyed, only ownership is dropped.
+					static_cast<void>(object.release());
+					++count;
+				}
+			}
+
+			MemoryTracker::global().recordFree(_memory_tag, sizeof(T) * count, count);
+
+			return count;
+		}
+
+		// Destroys every live object in one pass and makes every slot available again. Any unique_ptr_t still
+		// pointing into the pool must have given up ownership with unique_ptr::release beforehand, for bulk clears of
+		// objects that are tracked some other way. A lock free pool must not be used by other threads meanwhile.
+		void reset() noexcept
+		{
+			std::scoped_lock lock(mutex);
+
+			std::size_t count = 0;
+
+			_forEachOccupied([this, &count](std::uint32_t index) noexcept {
+				_object(index)->~T();
+
+				_clearOccupied(index);
+
+				_push(index);
+
+				++count;
+			});
+
+			MemoryTracker::global().recordFree(_memory_tag, sizeof(T) * count, count);
 		}
 
+		// Calls function with every live object, in slot order, while holding the pool's lock. function must not
+		// allocate from or release to this pool. A lock free pool must not be used by other threads meanwhile.
+		template<typename Function> requires std::invocable<Function&, T&>
+		void for_each_live(Function&& function)
+		{
+			std::scoped_lock lock(mutex);
 
+			_forEachOccupied([this, &function](std::uint32_t index) { function(*_object(index)); });
+		}
+
+		using occupancy_t = std::array<std::uint64_t, _OCCUPANCY_WORDS>;
+
+		// Copy of the occupancy bitmap, bit i of word i / 64 is set while slot i holds a live object. Consistent
+		// unless the pool is lock free and other threads are using it.
+		[[nodiscard]] occupancy_t getOccupancy()
+		{
+			std::scoped_lock lock(mutex);
+
+			occupancy_t occupancy;
+			for (auto word_index = std::size_t{0}; word_index < _OCCUPANCY_WORDS; ++word_index)
+			{
+				occupancy[word_index] = _loadOccupancy(word_index);
+			}
+
+			return occupancy;
+		}
 	};
 
 	/*namespace factory
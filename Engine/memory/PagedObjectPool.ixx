@@ -0,0 +1,283 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module PagedObjectPool;
+
+import std.compat;
+
+import Error;
+import MemoryTracking;
+
+using namespace mt::error;
+
+export namespace mt::memory
+{
+	// Object pool that grows a page at a time instead of being sized up front.
+	//
+	// Pages are never moved or resized, so objects stay where they were constructed. Each page is aligned to its own
+	// (power of two) size and starts with a header, so the page an object lives in is found by masking its address.
+	// Every page keeps its own free list, and pages with at least one free slot are kept on a doubly linked list, so
+	// allocate and release are O(1). Pages that become empty are kept around for reuse up to max_empty_pages, past
+	// that they are handed back to the system.
+	template<typename T, std::size_t objects_per_page = 64>
+	class PagedObjectPool
+	{
+		static_assert(objects_per_page > 0, "A page has to hold at least one object.");
+
+	public:
+		class Deleter
+		{
+			PagedObjectPool<T, objects_per_page>& _object_pool;
+
+		public:
+			Deleter(PagedObjectPool<T, objects_per_page>& object_pool)
+				: _object_pool(object_pool)
+			{}
+
+			void operator()(T const * pointer)
+			{
+				if (pointer) {
+					if (auto expected = _object_pool.releaseMemory(pointer); !expected) return;
+				}
+			}
+		};
+
+	private:
+		static constexpr std::uint32_t _NO_SLOT = std::numeric_limits<std::uint32_t>::max();
+
+		// A free slot holds the index of the next free slot in its page.
+		union Slot
+		{
+			std::uint32_t next;
+			alignas(T) std::byte object[sizeof(T)];
+		};
+
+		struct Page
+		{
+			PagedObjectPool* owner;
+			Page* previous;
+			Page* next;
+			std::uint32_t free_head;
+			// Slots past this index have never been handed out, so they are not on the free list yet.
+			std::uint32_t untouched;
+			std::uint32_t live;
+			bool is_partial;
+		};
+
+		static constexpr std::size_t _SLOT_OFFSET = (sizeof(Page) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+		static constexpr std::size_t _PAGE_BYTES = std::bit_ceil(_SLOT_OFFSET + objects_per_page * sizeof(Slot));
+
+		// Rounding the page up to a power of two usually leaves room for a few more objects.
+		static constexpr std::uint32_t _SLOTS_PER_PAGE =
+			static_cast<std::uint32_t>((_PAGE_BYTES - _SLOT_OFFSET) / sizeof(Slot));
+
+		std::mutex _mutex;
+
+		// Pages with at least one free slot, the most recently freed into is at the front.
+		Page* _partial_pages = nullptr;
+
+		std::size_t _size = 0;
+		std::size_t _page_count = 0;
+		std::size_t _empty_page_count = 0;
+		std::size_t _max_empty_pages;
+		std::size_t _max_pages;
+
+		// Pages are charged to the tag as they are created and destroyed.
+		MemoryTag _tag;
+
+		Deleter deleter {*this};
+
+		[[nodiscard]] static Slot* _getSlots(Page* page) noexcept
+		{
+			return reinterpret_cast<Slot*>(reinterpret_cast<std::byte*>(page) + _SLOT_OFFSET);
+		}
+
+		[[nodiscard]] static Page* _getPage(T const * object) noexcept
+		{
+			return reinterpret_cast<Page*>(reinterpret_cast<std::uintptr_t>(object) & ~(_PAGE_BYTES - 1));
+		}
+
+		void _pushPartial(Page* page) noexcept
+		{
+			page->previous = nullptr;
+			page->next = _partial_pages;
+
+			if (_partial_pages) _partial_pages->previous = page;
+
+			_partial_pages = page;
+			page->is_partial = true;
+		}
+
+		void _unlinkPartial(Page* page) noexcept
+		{
+			if (page->previous) page->previous->next = page->next;
+			else _partial_pages = page->next;
+
+			if (page->next) page->next->previous = page->previous;
+
+			page->previous = page->next = nullptr;
+			page->is_partial = false;
+		}
+
+		// Empty pages count against max_empty_pages until something is allocated from them.
+		[[nodiscard]] Page* _createPage() noexcept
+		{
+			if (_page_count >= _max_pages) return nullptr;
+
+			auto page = static_cast<Page*>(::operator new(_PAGE_BYTES, std::align_val_t{_PAGE_BYTES}, std::nothrow));
+
+			if (page == nullptr) return nullptr;
+
+			*page = Page{this, nullptr, nullptr, _NO_SLOT, 0, 0, false};
+
+			++_page_count;
+			++_empty_page_count;
+
+			MemoryTracker::global().recordReserve(_tag, _PAGE_BYTES);
+
+			_pushPartial(page);
+
+			return page;
+		}
+
+		void _destroyPage(Page* page) noexcept
+		{
+			--_page_count;
+
+			MemoryTracker::global().recordUnreserve(_tag, _PAGE_BYTES);
+
+			::operator delete(page, std::align_val_t{_PAGE_BYTES});
+		}
+
+		[[nodiscard]] bool releaseMemory(T const * returned_memory)
+		{
+			if (returned_memory == nullptr) return false;
+
+			// Check if we actually own this object.
+			auto page = _getPage(returned_memory);
+
+			if (page->owner != this) return false;
+
+			returned_memory->~T();
+
+			std::scoped_lock lock(_mutex);
+
+			auto& slot = *reinterpret_cast<Slot*>(const_cast<T*>(returned_memory));
+
+			slot.next = page->free_head;
+			page->free_head = static_cast<std::uint32_t>(&slot - _getSlots(page));
+
+			if (!page->is_partial) _pushPartial(page);
+
+			--_size;
+
+			if (--page->live == 0)
+			{
+				if (_empty_page_count < _max_empty_pages)
+				{
+					++_empty_page_count;
+				}
+				else
+				{
+					_unlinkPartial(page);
+					_destroyPage(page);
+				}
+			}
+
+			return true;
+		}
+
+	public:
+		friend PagedObjectPool::Deleter;
+
+		PagedObjectPool(
+			std::error_condition& error,
+			std::size_t max_empty_pages = 1,
+			std::size_t max_pages = std::numeric_limits<std::size_t>::max(),
+			MemoryTag tag = MemoryTag::UNTAGGED
+		) noexcept
+			: _max_empty_pages(max_empty_pages)
+			, _max_pages(max_pages)
+			, _tag(tag)
+		{
+			if (max_pages > 0 && _createPage() == nullptr)
+			{
+				Assign(error, mt::error::ErrorCode::BAD_ALLOCATION);
+			}
+		}
+
+		// Every unique_ptr_t holds a reference to this pool, so all of them must have been released by now, which
+		// leaves every remaining page on the partial list.
+		~PagedObjectPool() noexcept
+		{
+			while (_partial_pages)
+			{
+				auto page = _partial_pages;
+				_unlinkPartial(page);
+				_destroyPage(page);
+			}
+		};
+
+		PagedObjectPool(const PagedObjectPool& other) noexcept = delete;
+		PagedObjectPool(PagedObjectPool&& other) noexcept = delete;
+		PagedObjectPool& operator=(const PagedObjectPool& other) noexcept = delete;
+		PagedObjectPool& operator=(PagedObjectPool&& other) noexcept = delete;
+
+		[[nodiscard]] std::size_t size() noexcept
+		{
+			std::scoped_lock lock(_mutex);
+			return _size;
+		}
+
+		// Objects that fit in the pages allocated right now.
+		[[nodiscard]] std::size_t capacity() noexcept
+		{
+			std::scoped_lock lock(_mutex);
+			return _page_count * _SLOTS_PER_PAGE;
+		}
+
+		[[nodiscard]] std::size_t pageCount() noexcept
+		{
+			std::scoped_lock lock(_mutex);
+			return _page_count;
+		}
+
+		[[nodiscard]] static constexpr std::size_t objectsPerPage() noexcept { return _SLOTS_PER_PAGE; }
+
+		[[nodiscard]] static constexpr std::size_t pageBytes() noexcept { return _PAGE_BYTES; }
+
+		using unique_ptr_t = std::unique_ptr<T, Deleter>;
+
+		// Returns nullptr only when max_pages has been reached or a new page can not be allocated.
+		template<class... Types>
+		unique_ptr_t allocate(Types&&... args)
+		{
+			Slot* slot;
+			{
+				std::scoped_lock lock(_mutex);
+
+				auto page = _partial_pages ? _partial_pages : _createPage();
+
+				if (page == nullptr) return unique_ptr_t{nullptr, deleter};
+
+				auto slots = _getSlots(page);
+
+				if (page->free_head != _NO_SLOT)
+				{
+					slot = &slots[page->free_head];
+					page->free_head = slot->next;
+				}
+				else
+				{
+					slot = &slots[page->untouched++];
+				}
+
+				if (page->live++ == 0) --_empty_page_count;
+
+				if (page->live == _SLOTS_PER_PAGE) _unlinkPartial(page);
+
+				++_size;
+			}
+
+			return unique_ptr_t(new (slot->object) T(std::forward<Types>(args)...), deleter);
+		}
+	};
+}
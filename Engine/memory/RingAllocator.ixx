@@ -0,0 +1,263 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module RingAllocator;
+
+import std;
+
+import BackingStore;
+import Error;
+import ThreadingPolicy;
+
+using namespace mt::error;
+
+export namespace mt::memory
+{
+	// Memory handed out by RingAllocator::allocate. begin and end are the reserve cursor before and after the
+	// allocation and record is the cursor of data, commit needs them to publish it.
+	struct RingAllocation
+	{
+		std::byte* data = nullptr;
+		std::uint64_t begin = 0;
+		std::uint64_t record = 0;
+		std::uint64_t end = 0;
+
+		[[nodiscard]] explicit operator bool() const noexcept { return data != nullptr; }
+	};
+
+	// Byte ring for variable size records that are freed in the order they were allocated.
+	//
+	// Cursors count bytes since construction and only ever grow, a cursor modulo the capacity is its position in the
+	// buffer. Producers move the reserve cursor in allocate, then fill the record and commit it. The single consumer
+	// reads committed records with front and frees them with release, which moves the release cursor.
+	//
+	// A record that does not fit before the end of the buffer starts again at the beginning, the bytes it skipped are
+	// freed when the consumer reaches them. The consumer has to ask front for the same alignment the record was
+	// allocated with.
+	//
+	// ThreadingPolicy decides how producers share the ring, see ThreadingPolicy.ixx. There is only ever one consumer,
+	// it may run on a different thread to the producers with any thread safe policy.
+	//  - SingleThreadedPolicy and MutexPolicy: commit moves a commit cursor, in allocation order. A producer that
+	//    finishes early waits for the ones that allocated before it. Records carry no header.
+	//  - LockFreePolicy: producers reserve with a compare and swap and commit by stamping a header in front of their
+	//    own record, so no producer ever waits on another. The consumer stops at the first record that is not stamped
+	//    yet. The header costs _STAMP_SIZE bytes a record and there is no commit cursor.
+	template<ThreadingPolicyType ThreadingPolicy = LockFreePolicy>
+	class RingAllocator
+	{
+		static constexpr std::size_t _CACHE_LINE = std::hardware_destructive_interference_size;
+		static constexpr bool _IS_STAMPED = ThreadingPolicy::IS_LOCK_FREE;
+		// The stamp is the record's reserve cursor plus one, so neither zeroed memory nor an older record's stamp can
+		// be mistaken for it. Payloads could hold any value, so the buffer starts zeroed and release zeroes them again.
+		static constexpr std::size_t _STAMP_SIZE = _IS_STAMPED ? sizeof(std::uint64_t) : 0;
+
+		std::unique_ptr<std::byte, void(*)(void*)> _data;
+		std::size_t _capacity;
+
+		// Producer side.
+		alignas(_CACHE_LINE) std::atomic<std::uint64_t> _reserve = 0;
+		// Reserve cursor of the last record that started again at the beginning of the buffer, the bytes from here to
+		// the end of the buffer are skipped.
+		std::atomic<std::uint64_t> _rollover = std::numeric_limits<std::uint64_t>::max();
+		[[no_unique_address]] typename ThreadingPolicy::mutex_type _reserve_mutex;
+
+		// Unused by stamped records.
+		alignas(_CACHE_LINE) std::atomic<std::uint64_t> _commit = 0;
+
+		// Consumer side.
+		alignas(_CACHE_LINE) std::atomic<std::uint64_t> _release = 0;
+
+		[[nodiscard]] std::size_t _getPadding(std::uint64_t cursor, std::size_t alignment) const noexcept
+		{
+			const auto address = reinterpret_cast<std::uintptr_t>(_data.get() + cursor % _capacity);
+
+			return (alignment - address % alignment) % alignment;
+		}
+
+		[[nodiscard]] std::uint64_t _getNextLap(std::uint64_t cursor) const noexcept
+		{
+			return (cursor / _capacity + 1) * _capacity;
+		}
+
+		// Cursor of the data of a record reserved at cursor, which has to start at the next lap when is_rollover.
+		[[nodiscard]] std::uint64_t _getRecord(
+			std::uint64_t cursor, std::size_t alignment, bool is_rollover
+		) const noexcept
+		{
+			auto record = (is_rollover ? _getNextLap(cursor) : cursor) + _STAMP_SIZE;
+
+			return record + _getPadding(record, alignment);
+		}
+
+		[[nodiscard]] std::atomic_ref<std::uint64_t> _getStamp(std::uint64_t record) const noexcept
+		{
+			return std::atomic_ref<std::uint64_t>(
+				*reinterpret_cast<std::uint64_t*>(_data.get() + (record - _STAMP_SIZE) % _capacity)
+			);
+		}
+
+		// Bytes between the release and reserve cursors that a rollover skipped.
+		[[nodiscard]] std::size_t _getSkippedBytes(std::uint64_t release, std::uint64_t reserve) const noexcept
+		{
+			const auto rollover = _rollover.load(std::memory_order_relaxed);
+
+			return rollover >= release && rollover < reserve ? _getNextLap(rollover) - rollover : 0;
+		}
+
+	public:
+		template<BackingStorePolicy BackingStore = MallocBackingStore>
+		RingAllocator(std::size_t capacity, std::error_condition& error, BackingStore = {}) noexcept
+			: _data(static_cast<std::byte*>(BackingStore::allocate(capacity)), BackingStore::deallocate)
+			// Stamps are aligned to their size, which needs a capacity that is a multiple of it.
+			, _capacity(_data ? (_IS_STAMPED ? capacity / _STAMP_SIZE * _STAMP_SIZE : capacity) : 0)
+		{
+			if (!_data)
+			{
+				Assign(error, ErrorCode::BAD_ALLOCATION);
+			}
+			else if constexpr (_IS_STAMPED)
+			{
+				std::memset(_data.get(), 0, _capacity);
+			}
+		}
+
+		~RingAllocator() noexcept = default;
+		RingAllocator(const RingAllocator&) = delete;
+		RingAllocator(RingAllocator&&) = delete;
+		RingAllocator& operator=(const RingAllocator&) = delete;
+		RingAllocator& operator=(RingAllocator&&) = delete;
+
+		// Reserves bytes aligned to alignment, which must be a power of two. Returns an empty allocation when there is
+		// not enough free space, nothing is reserved in that case. Every allocation that is returned must be committed.
+		[[nodiscard]] RingAllocation allocate(
+			std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)
+		) noexcept
+		{
+			if (bytes == 0 || bytes > _capacity) return {};
+
+			if constexpr (_IS_STAMPED) alignment = std::max(alignment, _STAMP_SIZE);
+
+			[[maybe_unused]] auto lock = std::scoped_lock(_reserve_mutex);
+
+			auto reserve = _reserve.load(std::memory_order_relaxed);
+
+			while (true)
+			{
+				auto record = _getRecord(reserve, alignment, false);
+				const bool is_rollover = reserve % _capacity + (record - reserve) + bytes > _capacity;
+
+				if (is_rollover) record = _getRecord(reserve, alignment, true);
+
+				const auto end = record + bytes;
+
+				// Acquire, so the consumer is done reading the memory before it is handed out again.
+				if (end - _release.load(std::memory_order_acquire) > _capacity) return {};
+
+				if constexpr (ThreadingPolicy::IS_LOCK_FREE)
+				{
+					if (!_reserve.compare_exchange_weak(reserve, end, std::memory_order_relaxed)) continue;
+				}
+				else
+				{
+					_reserve.store(end, std::memory_order_relaxed);
+				}
+
+				// Published to the consumer by this allocation's commit.
+				if (is_rollover) _rollover.store(reserve, std::memory_order_release);
+
+				return RingAllocation{_data.get() + record % _capacity, reserve, record, end};
+			}
+		}
+
+		// Makes the allocation visible to the consumer. Stamped records are visible straight away, otherwise once
+		// every allocation made before it has been committed.
+		void commit(const RingAllocation& allocation) noexcept
+		{
+			if constexpr (_IS_STAMPED)
+			{
+				_getStamp(allocation.record).store(allocation.begin + 1, std::memory_order_release);
+			}
+			else
+			{
+				while (_commit.load(std::memory_order_acquire) != allocation.begin)
+				{
+					std::this_thread::yield();
+				}
+
+				_commit.store(allocation.end, std::memory_order_release);
+			}
+		}
+
+		// The oldest committed record that has not been released, nullptr when there is none or it is not committed
+		// yet. Only the consumer may call front and release.
+		[[nodiscard]] std::byte* front(std::size_t alignment = alignof(std::max_align_t)) noexcept
+		{
+			const auto release = _release.load(std::memory_order_relaxed);
+
+			if constexpr (!_IS_STAMPED)
+			{
+				if (release == _commit.load(std::memory_order_acquire)) return nullptr;
+			}
+			else
+			{
+				alignment = std::max(alignment, _STAMP_SIZE);
+			}
+
+			// A rollover that is not visible yet belongs to a record that is not committed yet.
+			const auto record = _getRecord(release, alignment, release == _rollover.load(std::memory_order_acquire));
+
+			if constexpr (_IS_STAMPED)
+			{
+				if (_getStamp(record).load(std::memory_order_acquire) != release + 1) return nullptr;
+			}
+
+			// Skipped, stamp and padding bytes are free as soon as the consumer is past them.
+			_release.store(record, std::memory_order_release);
+
+			return _data.get() + record % _capacity;
+		}
+
+		// Frees the first bytes of the record returned by front.
+		void release(std::size_t bytes) noexcept
+		{
+			const auto release = _release.load(std::memory_order_relaxed);
+
+			// Before the release cursor moves past them, a producer may reuse them straight after.
+			if constexpr (_IS_STAMPED) std::memset(_data.get() + release % _capacity, 0, bytes);
+
+			_release.store(release + bytes, std::memory_order_release);
+		}
+
+		[[nodiscard]] std::size_t getCapacity() const noexcept { return _capacity; }
+
+		[[nodiscard]] std::uint64_t getReserveCursor() const noexcept
+		{
+			return _reserve.load(std::memory_order_acquire);
+		}
+
+		[[nodiscard]] std::uint64_t getCommitCursor() const noexcept requires (!_IS_STAMPED)
+		{
+			return _commit.load(std::memory_order_acquire);
+		}
+
+		[[nodiscard]] std::uint64_t getReleaseCursor() const noexcept
+		{
+			return _release.load(std::memory_order_acquire);
+		}
+
+		// Bytes held by records that have not been released, including alignment padding but not the bytes skipped by
+		// a rollover. Approximate while producers are allocating.
+		[[nodiscard]] std::size_t getUsedSpace() const noexcept
+		{
+			const auto release = _release.load(std::memory_order_acquire);
+			const auto reserve = _reserve.load(std::memory_order_acquire);
+
+			return reserve - release - _getSkippedBytes(release, reserve);
+		}
+
+		// Skipped bytes count as free, so a record as large as getFreeSpace() may still not fit until the consumer
+		// catches up.
+		[[nodiscard]] std::size_t getFreeSpace() const noexcept
+		{
+			return _capacity - getUsedSpace();
+		}
+	};
+}
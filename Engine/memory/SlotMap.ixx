@@ -0,0 +1,167 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module SlotMap;
+
+import std;
+
+export import Handle;
+
+export namespace mt::memory
+{
+	// Stores objects contiguously and hands out generational handles to them.
+	//
+	// Lookup and erase are O(1). Erase moves the last object into the hole, so the live objects are always the
+	// first size() elements of a dense array and can be iterated without chasing pointers. Pointers and references
+	// into the map are invalidated by insert and erase, hold a SlotHandle instead.
+	//
+	// Not thread safe.
+	template<typename T>
+	class SlotMap
+	{
+		struct Slot
+		{
+			// Index into _objects while the slot is live, index of the next free slot otherwise.
+			std::uint32_t index;
+			std::uint32_t generation;
+		};
+
+		static constexpr std::uint32_t _NO_SLOT = SlotHandle<T>::NULL_INDEX;
+
+		std::pmr::vector<T>				_objects;
+		std::pmr::vector<std::uint32_t>	_object_slots;
+		std::pmr::vector<Slot>			_slots;
+
+		std::uint32_t _free_slot = _NO_SLOT;
+
+		[[nodiscard]] const Slot* _findSlot(SlotHandle<T> handle) const noexcept
+		{
+			if (handle.index >= _slots.size()) return nullptr;
+
+			const auto& slot = _slots[handle.index];
+
+			return slot.generation == handle.generation ? &slot : nullptr;
+		}
+
+	public:
+		using handle_t = SlotHandle<T>;
+
+		SlotMap() noexcept = default;
+
+		explicit SlotMap(std::pmr::memory_resource* memory_resource) noexcept
+			: _objects(memory_resource)
+			, _object_slots(memory_resource)
+			, _slots(memory_resource)
+		{}
+
+		~SlotMap() noexcept = default;
+		SlotMap(const SlotMap&) = default;
+		SlotMap(SlotMap&&) noexcept = default;
+		SlotMap& operator=(const SlotMap&) = default;
+		SlotMap& operator=(SlotMap&&) noexcept = default;
+
+		void reserve(std::size_t capacity)
+		{
+			_objects.reserve(capacity);
+			_object_slots.reserve(capacity);
+			_slots.reserve(capacity);
+		}
+
+		template<class... Types>
+		handle_t insert(Types&&... args)
+		{
+			std::uint32_t slot_index;
+
+			if (_free_slot != _NO_SLOT)
+			{
+				slot_index = _free_slot;
+				_free_slot = _slots[slot_index].index;
+			}
+			else
+			{
+				slot_index = static_cast<std::uint32_t>(_slots.size());
+				_slots.push_back(Slot{_NO_SLOT, 0});
+			}
+
+			auto& slot = _slots[slot_index];
+
+			slot.index = static_cast<std::uint32_t>(_objects.size());
+
+			_objects.emplace_back(std::forward<Types>(args)...);
+			_object_slots.push_back(slot_index);
+
+			return handle_t{slot_index, slot.generation};
+		}
+
+		bool erase(handle_t handle) noexcept
+		{
+			if (_findSlot(handle) == nullptr) return false;
+
+			auto& slot = _slots[handle.index];
+			const auto object_index = slot.index;
+			const auto last_index = static_cast<std::uint32_t>(_objects.size() - 1);
+
+			if (object_index != last_index)
+			{
+				_objects[object_index] = std::move(_objects[last_index]);
+				_object_slots[object_index] = _object_slots[last_index];
+				_slots[_object_slots[object_index]].index = object_index;
+			}
+
+			_objects.pop_back();
+			_object_slots.pop_back();
+
+			++slot.generation;
+			slot.index = _free_slot;
+			_free_slot = handle.index;
+
+			return true;
+		}
+
+		void clear() noexcept
+		{
+			for (auto object_index = std::size_t{0}; object_index < _object_slots.size(); ++object_index)
+			{
+				const auto slot_index = _object_slots[object_index];
+				auto& slot = _slots[slot_index];
+
+				++slot.generation;
+				slot.index = _free_slot;
+				_free_slot = slot_index;
+			}
+
+			_objects.clear();
+			_object_slots.clear();
+		}
+
+		[[nodiscard]] T* get(handle_t handle) noexcept
+		{
+			auto slot = _findSlot(handle);
+			return slot ? &_objects[slot->index] : nullptr;
+		}
+
+		[[nodiscard]] const T* get(handle_t handle) const noexcept
+		{
+			auto slot = _findSlot(handle);
+			return slot ? &_objects[slot->index] : nullptr;
+		}
+
+		[[nodiscard]] bool contains(handle_t handle) const noexcept { return _findSlot(handle) != nullptr; }
+
+		// Handle of the object at a position in the dense array, for use while iterating.
+		[[nodiscard]] handle_t handleAt(std::size_t object_index) const noexcept
+		{
+			const auto slot_index = _object_slots[object_index];
+			return handle_t{slot_index, _slots[slot_index].generation};
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return _objects.size(); }
+		[[nodiscard]] bool empty() const noexcept { return _objects.empty(); }
+
+		[[nodiscard]] std::span<T> objects() noexcept { return _objects; }
+		[[nodiscard]] std::span<const T> objects() const noexcept { return _objects; }
+
+		[[nodiscard]] auto begin() noexcept { return _objects.begin(); }
+		[[nodiscard]] auto end() noexcept { return _objects.end(); }
+		[[nodiscard]] auto begin() const noexcept { return _objects.begin(); }
+		[[nodiscard]] auto end() const noexcept { return _objects.end(); }
+	};
+}
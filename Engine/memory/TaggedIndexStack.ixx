@@ -0,0 +1,129 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module TaggedIndexStack;
+
+import std.compat;
+
+export namespace mt::memory
+{
+	// Lock free stack of 32-bit slot indices, the free list of the lock free pools.
+	//
+	// A Treiber stack: every index owns an atomic link to the index below it, kept in a side array rather than in the
+	// slot itself, because a thread that lost the race to pop a slot may still be reading its link while the winner
+	// constructs an object over it. The head packs the top index with a 32-bit tag that is bumped on every push and
+	// pop, so a head that was popped and pushed back between a load and a compare exchange (ABA) is detected.
+	class TaggedIndexStack
+	{
+	public:
+		static constexpr std::uint32_t NO_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+	private:
+		std::unique_ptr<std::atomic<std::uint32_t>[]> _next;
+
+		// Written by every thread, keep it away from whatever the owner puts before the stack.
+		alignas(std::hardware_destructive_interference_size) std::atomic<std::uint64_t> _head{_pack(NO_INDEX, 0)};
+
+		static constexpr std::uint64_t _pack(std::uint32_t index, std::uint32_t tag) noexcept
+		{
+			return (static_cast<std::uint64_t>(tag) << 32) | index;
+		}
+
+		static constexpr std::uint32_t _headIndex(std::uint64_t head) noexcept
+		{
+			return static_cast<std::uint32_t>(head);
+		}
+
+		static constexpr std::uint32_t _headTag(std::uint64_t head) noexcept
+		{
+			return static_cast<std::uint32_t>(head >> 32);
+		}
+
+	public:
+		// Starts empty. Check isValid(), the links are allocated without throwing.
+		explicit TaggedIndexStack(std::size_t capacity) noexcept
+			: _next(new (std::nothrow) std::atomic<std::uint32_t>[capacity])
+		{}
+
+		~TaggedIndexStack() noexcept = default;
+		TaggedIndexStack(const TaggedIndexStack&) = delete;
+		TaggedIndexStack(TaggedIndexStack&&) = delete;
+		TaggedIndexStack& operator=(const TaggedIndexStack&) = delete;
+		TaggedIndexStack& operator=(TaggedIndexStack&&) = delete;
+
+		// Bytes of links a stack of capacity indices holds.
+		[[nodiscard]] static constexpr std::size_t getReservedBytes(std::size_t capacity) noexcept
+		{
+			return sizeof(std::atomic<std::uint32_t>) * capacity;
+		}
+
+		[[nodiscard]] bool isValid() const noexcept { return _next != nullptr; }
+
+		// Pushes every index below capacity with 0 on top, so the first pops are the lowest addresses. Not thread safe.
+		void fill(std::uint32_t capacity) noexcept
+		{
+			for (std::uint32_t i = 0; i < capacity; i++)
+			{
+				_next[i].store(i + 1 < capacity ? i + 1 : NO_INDEX, std::memory_order_relaxed);
+			}
+
+			_head.store(_pack(capacity > 0 ? 0 : NO_INDEX, 0), std::memory_order_release);
+		}
+
+		// NO_INDEX when the stack is empty.
+		[[nodiscard]] std::uint32_t pop() noexcept
+		{
+			std::uint32_t index;
+
+			return popChain(std::span<std::uint32_t>(&index, 1)) == 0 ? NO_INDEX : index;
+		}
+
+		void push(std::uint32_t index) noexcept
+		{
+			pushChain(std::span<const std::uint32_t>(&index, 1));
+		}
+
+		// Pops up to indices.size() indices with a single successful exchange, returns how many it popped.
+		std::size_t popChain(std::span<std::uint32_t> indices) noexcept
+		{
+			auto head = _head.load(std::memory_order_acquire);
+
+			std::size_t count;
+			std::uint32_t next;
+			do
+			{
+				count = 0;
+				next = _headIndex(head);
+
+				while (count < indices.size() && next != NO_INDEX)
+				{
+					indices[count++] = next;
+					next = _next[next].load(std::memory_order_relaxed);
+				}
+
+				if (count == 0) return 0;
+
+				// If any of the walked indices were popped by another thread the tag has moved and this fails.
+			} while (!_head.compare_exchange_weak(
+				head, _pack(next, _headTag(head) + 1), std::memory_order_acquire, std::memory_order_acquire
+			));
+
+			return count;
+		}
+
+		// Pushes the indices with a single successful exchange, indices[0] ends up on top.
+		void pushChain(std::span<const std::uint32_t> indices) noexcept
+		{
+			for (auto i = std::size_t{1}; i < indices.size(); ++i)
+			{
+				_next[indices[i - 1]].store(indices[i], std::memory_order_relaxed);
+			}
+
+			auto head = _head.load(std::memory_order_relaxed);
+			do
+			{
+				_next[indices.back()].store(_headIndex(head), std::memory_order_relaxed);
+			} while (!_head.compare_exchange_weak(
+				head, _pack(indices.front(), _headTag(head) + 1), std::memory_order_release, std::memory_order_relaxed
+			));
+		}
+	};
+}
@@ -0,0 +1,50 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module ThreadingPolicy;
+
+import std;
+
+export namespace mt::memory
+{
+	// Stands in for a mutex where no locking is needed, std::scoped_lock on it compiles away.
+	struct NullMutex
+	{
+		constexpr void lock() noexcept {}
+		constexpr void unlock() noexcept {}
+	};
+
+	// Threading models for containers that can be shared between threads. IS_THREAD_SAFE says whether the container
+	// may be used from more than one thread at once, IS_LOCK_FREE whether it gets there with atomics instead of
+	// mutex_type.
+
+	// Only ever used from one thread, nothing is synchronized.
+	struct SingleThreadedPolicy
+	{
+		using mutex_type = NullMutex;
+		static constexpr bool IS_THREAD_SAFE = false;
+		static constexpr bool IS_LOCK_FREE = false;
+	};
+
+	// Every operation holds a std::mutex.
+	struct MutexPolicy
+	{
+		using mutex_type = std::mutex;
+		static constexpr bool IS_THREAD_SAFE = true;
+		static constexpr bool IS_LOCK_FREE = false;
+	};
+
+	// Operations synchronize with atomics and never block.
+	struct LockFreePolicy
+	{
+		using mutex_type = NullMutex;
+		static constexpr bool IS_THREAD_SAFE = true;
+		static constexpr bool IS_LOCK_FREE = true;
+	};
+
+	template<typename Policy>
+	concept ThreadingPolicyType = requires
+	{
+		typename Policy::mutex_type;
+		{ Policy::IS_THREAD_SAFE } -> std::convertible_to<bool>;
+		{ Policy::IS_LOCK_FREE } -> std::convertible_to<bool>;
+	};
+}
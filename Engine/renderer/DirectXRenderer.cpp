@@ -202,6 +202,9 @@ std::expected<void, std::error_condition> DirectXRenderer::update() noexcept
 		CloseHandle(eventHandle);
 	}
 
+	// The GPU is done with this frame resource, so is everything that was allocated for it.
+	_frame_arena.beginFrame(_frame_resource_index);
+
 	_updateObjectConstants();
 	_updatePassConstants();
 
@@ -214,16 +217,16 @@ void DirectXRenderer::_updateObjectConstants() noexcept
 
 	for (auto& render_item : _render_items)
 	{
-		if (render_item->requiresUpdate())
+		if (render_item.requiresUpdate())
 		{
 			// Update the constant buffer with the latest worldViewProj matrix.
 			ObjectConstants object_constants;
 			// The transpose is necessary because we are switching from row major (DirectXMath) to column major (HLSL)
-			DirectX::XMMATRIX world_matrix = XMLoadFloat4x4(&render_item->world_matrix);
+			DirectX::XMMATRIX world_matrix = XMLoadFloat4x4(&render_item.world_matrix);
 			XMStoreFloat4x4(&object_constants.world_matrix, XMMatrixTranspose(world_matrix));
-			current_upload_buffer->CopyData(render_item->object_constant_buffer_index, object_constants);
+			current_upload_buffer->CopyData(render_item.object_constant_buffer_index, object_constants);
 
-			render_item->objectConstantsUpdated();
+			render_item.objectConstantsUpdated();
 		}
 	}
 }
@@ -367,21 +370,21 @@ std::expected<void, std::error_condition> DirectXRenderer::_createCommandList()
 }
 
 void DirectXRenderer::_drawRenderItems(
-	ID3D12GraphicsCommandList* command_list, const std::vector<std::unique_ptr<RenderItem>>& render_items
+	ID3D12GraphicsCommandList* command_list, const mt::memory::SlotMap<RenderItem>& render_items
 ) noexcept
 {
 	for (auto& render_item : render_items)
 	{
-		auto vertex_buffer_view = render_item->geometry->vertexBufferView();
+		auto vertex_buffer_view = render_item.geometry->vertexBufferView();
 		command_list->IASetVertexBuffers(0, 1, &vertex_buffer_view);
 
-		auto index_buffer_view = render_item->geometry->indexBufferView();
+		auto index_buffer_view = render_item.geometry->indexBufferView();
 		command_list->IASetIndexBuffer(&index_buffer_view);
 
-		command_list->IASetPrimitiveTopology(render_item->primitive_topology);
+		command_list->IASetPrimitiveTopology(render_item.primitive_topology);
 
 		UINT cbv_heap_index = static_cast<UINT>(
-			_frame_resource_index * (UINT)render_items.size() + render_item->object_constant_buffer_index
+			_frame_resource_index * (UINT)render_items.size() + render_item.object_constant_buffer_index
 		);
 
 		auto cbv_handle = CD3DX12_GPU_DESCRIPTOR_HANDLE(_dx_cbv_heap->GetGPUDescriptorHandleForHeapStart());
@@ -390,10 +393,10 @@ void DirectXRenderer::_drawRenderItems(
 		command_list->SetGraphicsRootDescriptorTable(0, cbv_handle);
 
 		command_list->DrawIndexedInstanced(
-			render_item->index_count,
+			render_item.index_count,
 			1,
-			render_item->start_index_location,
-			render_item->base_vertex_location,
+			render_item.start_index_location,
+			render_item.base_vertex_location,
 			0
 		);
 	}
@@ -769,7 +772,7 @@ std::expected<void, std::error_condition> DirectXRenderer::_createGeometry() noe
 	const UINT vbByteSize = (UINT) vertices.size() * sizeof(mt::renderer::Vertex);
 	const UINT ibByteSize = (UINT) box.indices.size() * sizeof(uint16_t);
 
-	if (auto expected = mt::memory::factory::MeshGeometry("box"); !expected)
+	if (auto expected = mt::memory::factory::MeshGeometry("box", _geometry_memory_resource); !expected)
 		return std::unexpected(expected.error());
 	else
 		_box_mesh_geometry = std::move(expected.value());
@@ -833,65 +836,65 @@ void DirectXRenderer::_createRenderItems() noexcept
 
 	for (auto index = -1; index < 2; index+=2)
 	{
-		auto box_render_item = std::make_unique<RenderItem>(static_cast<int>(_frame_resources.size()));
+		auto box_render_item = RenderItem(static_cast<int>(_frame_resources.size()));
 
 		// Set the world matrix
 		XMStoreFloat4x4(
-			&box_render_item->world_matrix,
+			&box_render_item.world_matrix,
 			DirectX::XMMatrixScaling(1.0f, 1.0f, 1.0f) * DirectX::XMMatrixTranslation(0.0f, 0.0f, 5.0f * index)
 		);
 
-		box_render_item->object_constant_buffer_index = ++object_constant_buffer_index;
-		box_render_item->geometry = _box_mesh_geometry.get();
-		box_render_item->primitive_topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+		box_render_item.object_constant_buffer_index = ++object_constant_buffer_index;
+		box_render_item.geometry = _box_mesh_geometry.get();
+		box_render_item.primitive_topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
-		auto& submesh_geometry = box_render_item->geometry->draw_arguments["box"];
+		auto& submesh_geometry = box_render_item.geometry->draw_arguments["box"];
 
-		box_render_item->index_count = submesh_geometry.index_count;
-		box_render_item->start_index_location = submesh_geometry.start_index_location;
-		box_render_item->base_vertex_location = submesh_geometry.base_vertex_location;
+		box_render_item.index_count = submesh_geometry.index_count;
+		box_render_item.start_index_location = submesh_geometry.start_index_location;
+		box_render_item.base_vertex_location = submesh_geometry.base_vertex_location;
 
-		_render_items.push_back(std::move(box_render_item));
+		_render_items.insert(box_render_item);
 
-		box_render_item = std::make_unique<RenderItem>(static_cast<int>(_frame_resources.size()));
+		box_render_item = RenderItem(static_cast<int>(_frame_resources.size()));
 
 		// Set the world matrix
 		XMStoreFloat4x4(
-			&box_render_item->world_matrix,
+			&box_render_item.world_matrix,
 			DirectX::XMMatrixScaling(1.0f, 1.0f, 1.0f) * DirectX::XMMatrixTranslation(0.0f, 5.0f * index, 0.0f)
 		);
 
-		box_render_item->object_constant_buffer_index = ++object_constant_buffer_index;
-		box_render_item->geometry = _box_mesh_geometry.get();
-		box_render_item->primitive_topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+		box_render_item.object_constant_buffer_index = ++object_constant_buffer_index;
+		box_render_item.geometry = _box_mesh_geometry.get();
+		box_render_item.primitive_topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
-		submesh_geometry = box_render_item->geometry->draw_arguments["box"];
+		submesh_geometry = box_render_item.geometry->draw_arguments["box"];
 
-		box_render_item->index_count = submesh_geometry.index_count;
-		box_render_item->start_index_location = submesh_geometry.start_index_location;
-		box_render_item->base_vertex_location = submesh_geometry.base_vertex_location;
+		box_render_item.index_count = submesh_geometry.index_count;
+		box_render_item.start_index_location = submesh_geometry.start_index_location;
+		box_render_item.base_vertex_location = submesh_geometry.base_vertex_location;
 
-		_render_items.push_back(std::move(box_render_item));
+		_render_items.insert(box_render_item);
 
-		box_render_item = std::make_unique<RenderItem>(static_cast<int>(_frame_resources.size()));
+		box_render_item = RenderItem(static_cast<int>(_frame_resources.size()));
 
 		// Set the world matrix
 		XMStoreFloat4x4(
-			&box_render_item->world_matrix,
+			&box_render_item.world_matrix,
 			DirectX::XMMatrixScaling(1.0f, 1.0f, 1.0f) * DirectX::XMMatrixTranslation(5.0f * index, 0.0f, 0.0f)
 		);
 
-		box_render_item->object_constant_buffer_index = ++object_constant_buffer_index;
-		box_render_item->geometry = _box_mesh_geometry.get();
-		box_render_item->primitive_topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+		box_render_item.object_constant_buffer_index = ++object_constant_buffer_index;
+		box_render_item.geometry = _box_mesh_geometry.get();
+		box_render_item.primitive_topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
-		submesh_geometry = box_render_item->geometry->draw_arguments["box"];
+		submesh_geometry = box_render_item.geometry->draw_arguments["box"];
 
-		box_render_item->index_count = submesh_geometry.index_count;
-		box_render_item->start_index_location = submesh_geometry.start_index_location;
-		box_render_item->base_vertex_location = submesh_geometry.base_vertex_location;
+		box_render_item.index_count = submesh_geometry.index_count;
+		box_render_item.start_index_location = submesh_geometry.start_index_location;
+		box_render_item.base_vertex_location = submesh_geometry.base_vertex_location;
 
-		_render_items.push_back(std::move(box_render_item));
+		_render_items.insert(box_render_item);
 	}
 }
 
@@ -30,6 +30,7 @@ export import Geometry;
 export import MathUtility;
 export import UploadBuffer;
 export import RenderItem;
+export import SlotMap;
 export import renderer.Vertex;
 
 using Microsoft::WRL::ComPtr;
@@ -47,9 +48,13 @@ export namespace mt::renderer
     protected:
         // Data
 		static const std::size_t _number_of_frame_resources = 2;
+		static const std::size_t _frame_arena_bytes_per_frame = 64 * 1024;
 
         Engine& _engine;
 
+		// Backs the mesh geometry's draw arguments, which are only built at startup.
+		std::pmr::memory_resource* _geometry_memory_resource;
+
         // 32 byte type
         vector<D3D12_INPUT_ELEMENT_DESC> mInputLayout; // 32 bytes according to sizeof
 
@@ -79,7 +84,10 @@ export namespace mt::renderer
         ComPtr<ID3D12DescriptorHeap> _dx_rtv_heap;
         ComPtr<ID3D12DescriptorHeap> _dx_dsv_heap;
 
-		vector<std::unique_ptr<RenderItem>> _render_items;
+		mt::memory::SlotMap<RenderItem> _render_items;
+
+		// One buffer per frame resource, a buffer is rewound once its frame resource's fence has been passed.
+		mt::memory::FrameArena _frame_arena;
 
         ComPtr<ID3D12RootSignature> _dx_root_signature;
         ComPtr<ID3D12DescriptorHeap> _dx_cbv_heap;
@@ -134,7 +142,7 @@ export namespace mt::renderer
 		[[nodiscard]] std::expected<void, std::error_condition> _createDxCommandObjects() noexcept;
 
 		void _drawRenderItems(
-			ID3D12GraphicsCommandList* command_list, const std::vector<std::unique_ptr<RenderItem>>& render_items
+			ID3D12GraphicsCommandList* command_list, const mt::memory::SlotMap<RenderItem>& render_items
 		) noexcept;
 
 		[[nodiscard]] std::expected<void, std::error_condition> _createSwapChain() noexcept;
@@ -160,16 +168,24 @@ export namespace mt::renderer
 		void _updatePassConstants() noexcept;
 
     public:
-        DirectXRenderer(Engine& engine) noexcept
+        DirectXRenderer(
+			Engine& engine,
+			std::error_condition& error,
+			std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource(),
+			std::pmr::memory_resource* geometry_memory_resource = std::pmr::get_default_resource()
+		) noexcept
             : RendererInterface(105.0f, engine.getWindowManager()->getWindowAspectRatio())
 			, _engine(engine)
+			, _geometry_memory_resource(geometry_memory_resource)
+			, _render_items(memory_resource)
+			, _frame_arena(_number_of_frame_resources, _frame_arena_bytes_per_frame, error)
         {}
 
         virtual ~DirectXRenderer() noexcept = default;
         DirectXRenderer(const DirectXRenderer&) noexcept = delete;
-        DirectXRenderer(DirectXRenderer&&) noexcept = default;
+        DirectXRenderer(DirectXRenderer&&) noexcept = delete;
         DirectXRenderer& operator=(const DirectXRenderer&) noexcept = delete;
-        DirectXRenderer& operator=(DirectXRenderer&&) noexcept = default;
+        DirectXRenderer& operator=(DirectXRenderer&&) noexcept = delete;
 
         // Accessors
 
@@ -179,6 +195,8 @@ export namespace mt::renderer
 			return _flushCommandQueue();
 		}
 
+		mt::memory::FrameArena& getFrameArena() noexcept override { return _frame_arena; }
+
 		[[nodiscard]] bool isCurrentFenceComplete() noexcept { return _fence->GetCompletedValue() >= _fence_index; }
 
 		// Mutators
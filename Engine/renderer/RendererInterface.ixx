@@ -5,6 +5,7 @@ import std;
 
 export import Camera;
 export import Error;
+export import FrameArena;
 
 using mt::error::Error;
 using mt::renderer::model::Camera;
@@ -70,6 +71,8 @@ export namespace mt::renderer
 
 		static constexpr unsigned int getSwapChainBufferCount() { return _swap_chain_buffer_count; };
 
+		// Scratch memory for the frame being built, released once the GPU is done with that frame.
+		virtual mt::memory::FrameArena& getFrameArena() noexcept = 0;
 
 		[[nodiscard]] virtual std::expected<void, std::error_condition> set4xMsaaState(bool value) noexcept = 0;
 
@@ -28,15 +28,16 @@ export namespace mt::renderer
 		std::string _name;
 
 		// TODO: improve this
-		MeshGeometry(std::string&& name) noexcept
+		MeshGeometry(std::string&& name, std::pmr::memory_resource* memory_resource) noexcept
 			: _name(name)
+			, draw_arguments(memory_resource)
 		{
 
 		}
 
 	public:
 		friend std::unique_ptr<MeshGeometry> mt::memory::make_unique_nothrow<MeshGeometry>(
-			std::string&& name
+			std::string&& name, std::pmr::memory_resource*& memory_resource
 		) noexcept;
 
 		~MeshGeometry() noexcept = default;
@@ -69,7 +70,7 @@ export namespace mt::renderer
 		// A MeshGeometry may store multiple geometries in one vertex/index buffer.
 		// Use this container to define the Submesh geometries so we can draw
 		// the Submeshes individually.
-		std::unordered_map<std::string, SubmeshGeometry> draw_arguments;
+		std::pmr::unordered_map<std::pmr::string, SubmeshGeometry> draw_arguments;
 
 
 		[[nodiscard]] inline D3D12_VERTEX_BUFFER_VIEW vertexBufferView() const noexcept
@@ -103,10 +104,10 @@ export namespace mt::renderer
 export namespace mt::memory::factory
 {
 	std::expected<std::unique_ptr<mt::renderer::MeshGeometry>, std::error_condition> MeshGeometry(
-		std::string&& name
+		std::string&& name, std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource()
 	) noexcept
 	{
-		auto ptr = make_unique_nothrow<mt::renderer::MeshGeometry>(std::forward<std::string>(name));
+		auto ptr = make_unique_nothrow<mt::renderer::MeshGeometry>(std::forward<std::string>(name), memory_resource);
 
 		if (ptr != nullptr)
 		{
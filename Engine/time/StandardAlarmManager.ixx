@@ -6,7 +6,7 @@ export import AlarmManager;
 
 export import gsl;
 export import Error;
-export import ObjectPool;
+export import SlotMap;
 export import TimeModel;
 
 import MakeUnique;
@@ -22,16 +22,32 @@ export namespace mt::time
 {
 	class StandardAlarmManager : public AlarmManagerInterface
 	{
-		mt::memory::ObjectPool<Alarm, 1024> _alarm_pool;
+		struct AlarmHandleCompare
+		{
+			const SlotMap<Alarm>* alarms;
+
+			bool operator()(SlotHandle<Alarm> alarm_1, SlotHandle<Alarm> alarm_2) const noexcept
+			{
+				return *alarms->get(alarm_2) < *alarms->get(alarm_1);
+			}
+		};
 
-		std::priority_queue < Alarm*, std::vector<Alarm*>, AlarmCompare > _alarm_queue;
+		// Alarms are stored densely so pause and resume walk a flat array. The queue holds handles, since the alarms
+		// themselves move whenever another alarm is erased.
+		SlotMap<Alarm> _alarms;
 
-		std::map<Alarm*, ObjectPool<Alarm, 1024>::unique_ptr_t> _alarms_and_timers;
+		std::priority_queue<SlotHandle<Alarm>, std::pmr::vector<SlotHandle<Alarm>>, AlarmHandleCompare> _alarm_queue;
 
 	public:
-		StandardAlarmManager(std::error_condition& error) noexcept
-			: _alarm_pool(error)
-		{}
+		StandardAlarmManager(
+			[[maybe_unused]] std::error_condition& error,
+			std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource()
+		) noexcept
+			: _alarms(memory_resource)
+			, _alarm_queue(AlarmHandleCompare{&_alarms}, std::pmr::vector<SlotHandle<Alarm>>(memory_resource))
+		{
+			_alarms.reserve(1024);
+		}
 
 		virtual ~StandardAlarmManager() noexcept = default;
 		StandardAlarmManager(const StandardAlarmManager& other) noexcept = delete;
@@ -41,46 +57,49 @@ export namespace mt::time
 		
 		void tick(steady_clock::time_point current_tick_time) noexcept override
 		{
-			if (!_alarm_queue.empty())
+			while (!_alarm_queue.empty())
 			{
-				Alarm* alarm = _alarm_queue.top();
+				const auto handle = _alarm_queue.top();
 
-				alarm->tick(current_tick_time);
+				// Pop before running the task, the task may add alarms which would change the top of the queue.
+				_alarm_queue.pop();
 
-				while (alarm->HasTriggered())
+				_alarms.get(handle)->tick(current_tick_time);
+
+				// Adding alarms may have moved this one, look it up again.
+				auto alarm = _alarms.get(handle);
+
+				if (!alarm->HasTriggered())
+				{
+					_alarm_queue.push(handle);
+					break;
+				}
+
+				if (alarm->doesAlarmRepeat())
+				{
+					alarm->reset();
+					_alarm_queue.push(handle);
+				}
+				else
 				{
-					if (alarm->doesAlarmRepeat())
-					{
-						alarm->reset();
-						_alarm_queue.push(alarm);
-					}
-					else
-					{
-						// This causes the smart pointer to release
-						_alarms_and_timers.erase(alarm);
-					}
-
-					// this will trigger a release, the unique_ptr is popped from the list and  ownership is not transferred.
-					_alarm_queue.pop();
-					alarm = _alarm_queue.top();
-					alarm->tick(current_tick_time);
+					_alarms.erase(handle);
 				}
 			}
 		}
 
 		void pause(steady_clock::time_point time_paused = steady_clock::now()) noexcept override
 		{
-			for (auto& alarm: _alarms_and_timers)
+			for (auto& alarm: _alarms)
 			{
-				alarm.second->pause(time_paused);
+				alarm.pause(time_paused);
 			}
 		}
 
 		void resume(steady_clock::time_point time_resumed = steady_clock::now()) noexcept override
 		{
-			for (auto& alarm: _alarms_and_timers)
+			for (auto& alarm: _alarms)
 			{
-				alarm.second->resume(time_resumed);
+				alarm.resume(time_resumed);
 			}
 		}
 
@@ -91,9 +110,7 @@ export namespace mt::time
 			steady_clock::duration repeat_interval = std::chrono::steady_clock::duration::min()
 		) noexcept
 		{
-			auto alarm = _alarm_pool.allocate(time_point, task, repeats, repeat_interval);
-			_alarm_queue.push(alarm.get());
-			_alarms_and_timers.insert({alarm.get(), std::move(alarm)});
+			_alarm_queue.push(_alarms.insert(time_point, task, repeats, repeat_interval));
 		}
 	};
 }
\ No newline at end of file
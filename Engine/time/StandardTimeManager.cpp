@@ -11,9 +11,11 @@ using namespace mt::error;
 using namespace mt::time;
 using namespace mt::time::model;
 
-StandardTimeManager::StandardTimeManager(mt::Engine& engine, std::error_condition& _alarm_manager_error) noexcept
-	: _alarm_manager(std::make_unique<StandardAlarmManager>(_alarm_manager_error))
-	, _stop_watches(_getStopWatches())
+StandardTimeManager::StandardTimeManager(
+	mt::Engine& engine, std::error_condition& _alarm_manager_error, std::pmr::memory_resource* memory_resource
+) noexcept
+	: _alarm_manager(std::make_unique<StandardAlarmManager>(_alarm_manager_error, memory_resource))
+	, _stop_watches(_getStopWatches(memory_resource))
 	, _engine(engine)
 	, _set_should_update(mt::time::TimeManagerSetShouldUpdate(engine))
 	, _set_should_render(mt::time::TimeManagerSetShouldRender(engine))
@@ -8,6 +8,7 @@ export import gsl;
 export import Engine;
 export import TimeManagerTasks;
 
+import EpochReclamation;
 import StopWatch;
 import Windows;
 
@@ -97,6 +98,9 @@ export namespace mt::time
 
 	class StandardTickFunction : public TickFunction
 	{
+		// Frames between memory and frame rate reports.
+		static constexpr long long MEMORY_REPORT_INTERVAL = 1440;
+
 		StopWatch* 	_tick_time 		= nullptr;
 		StopWatch* 	_update_time 	= nullptr;
 		StopWatch* 	_render_time 	= nullptr;
@@ -104,6 +108,21 @@ export namespace mt::time
 		StopWatch* 	_input_time 	= nullptr;
 		Engine* 	_engine 		= nullptr;
 
+		// Replaced once a report interval, the message thread reads it to report the frame rate.
+		std::atomic<FrameTimeReport*> _frame_time_report = nullptr;
+
+		void _publishFrameTimeReport(long long frames_rendered) noexcept
+		{
+			auto report = new (std::nothrow) FrameTimeReport{frames_rendered, _frame_time->getAverageTaskInterval()};
+			if (!report) return;
+
+			// A reader may still be pinned to the previous report, it is deleted once every reader has moved on.
+			if (auto previous = _frame_time_report.exchange(report, std::memory_order_acq_rel); previous)
+			{
+				mt::memory::EpochDomain::global().retire(previous);
+			}
+		}
+
 	public:
 		StandardTickFunction() = default;
 
@@ -123,6 +142,20 @@ export namespace mt::time
 			, _engine(engine)
 		{}
 
+		~StandardTickFunction() noexcept
+		{
+			if (auto report = _frame_time_report.load(std::memory_order_relaxed); report)
+			{
+				mt::memory::EpochDomain::global().retire(report);
+			}
+		}
+
+		// Pin to EpochDomain::global() for as long as the report is read.
+		[[nodiscard]] const FrameTimeReport* getFrameTimeReport() const noexcept
+		{
+			return _frame_time_report.load(std::memory_order_acquire);
+		}
+
 		virtual std::expected<void, std::error_condition> operator()() noexcept override
 		{
 			_tick_time->startTask();
@@ -151,11 +184,28 @@ export namespace mt::time
 				// Processing input could result in a shutdown.
 				if (!_engine->isShuttingDown())
 				{
+					// The barrier for events, every queue is drained before the game renders.
+					_engine->getEventManager()->processEvents(time_manager->getCurrentTickTime());
+
 					_engine->getGame()->renderUpdate();
 					auto renderer = _engine->getRenderer();
 					if (auto expected = renderer->update(); !expected) return std::unexpected(expected.error());
 					if (auto expected = renderer->render(); !expected) return std::unexpected(expected.error());
 					time_manager->renderComplete();
+
+					auto& memory_tracker = mt::memory::MemoryTracker::global();
+					memory_tracker.endFrame();
+
+					// Once a frame is the safe point for memory other threads may still be reading.
+					mt::memory::EpochDomain::global().advance();
+
+					if (const auto frames_rendered = renderer->getFramesRendered();
+						frames_rendered % MEMORY_REPORT_INTERVAL == 0
+					)
+					{
+						OutputDebugString(memory_tracker.getReport().c_str());
+						_publishFrameTimeReport(frames_rendered);
+					}
 				}
 
 				_frame_time->finishTask();
@@ -178,7 +228,7 @@ export namespace mt::time
 	{
 		std::unique_ptr<AlarmManagerInterface> _alarm_manager;
 
-		std::map<std::string_view, std::unique_ptr<StopWatch>>	_stop_watches;
+		std::pmr::map<std::string_view, std::unique_ptr<StopWatch>>	_stop_watches;
 
 		mt::Engine& _engine;
 
@@ -192,9 +242,11 @@ export namespace mt::time
 		ShuttingDownTickFunction _shutting_down_tick_function;
 		InitiateShutDownTickFunction _initiate_shut_down_tick_function;
 
-		std::map<std::string_view, std::unique_ptr<StopWatch>> _getStopWatches()
+		static std::pmr::map<std::string_view, std::unique_ptr<StopWatch>> _getStopWatches(
+			std::pmr::memory_resource* memory_resource
+		)
 		{
-			std::map<std::string_view, std::unique_ptr<StopWatch>> stop_watch;
+			std::pmr::map<std::string_view, std::unique_ptr<StopWatch>> stop_watch{memory_resource};
 
 			auto run_time = std::make_unique<StopWatch>(DefaultTimers::RUN_TIME);
 			auto windows_message_time = std::make_unique<StopWatch>(DefaultTimers::WINDOWS_MESSAGE_TIME);
@@ -204,19 +256,23 @@ export namespace mt::time
 			auto render_time = std::make_unique<StopWatch>(DefaultTimers::RENDER_TIME);
 			auto frame_time = std::make_unique<StopWatch>(DefaultTimers::FRAME_TIME);
 
-			_stop_watches.emplace(std::make_pair(DefaultTimers::RUN_TIME,				std::move(run_time)));
-			_stop_watches.emplace(std::make_pair(DefaultTimers::WINDOWS_MESSAGE_TIME,	std::move(windows_message_time)));
-			_stop_watches.emplace(std::make_pair(DefaultTimers::TICK_TIME,				std::move(tick_time)));
-			_stop_watches.emplace(std::make_pair(DefaultTimers::UPDATE_TIME,			std::move(update_time)));
-			_stop_watches.emplace(std::make_pair(DefaultTimers::INPUT_TIME,				std::move(input_time)));
-			_stop_watches.emplace(std::make_pair(DefaultTimers::RENDER_TIME,			std::move(render_time)));
-			_stop_watches.emplace(std::make_pair(DefaultTimers::FRAME_TIME,				std::move(frame_time)));
+			stop_watch.emplace(std::make_pair(DefaultTimers::RUN_TIME,				std::move(run_time)));
+			stop_watch.emplace(std::make_pair(DefaultTimers::WINDOWS_MESSAGE_TIME,	std::move(windows_message_time)));
+			stop_watch.emplace(std::make_pair(DefaultTimers::TICK_TIME,				std::move(tick_time)));
+			stop_watch.emplace(std::make_pair(DefaultTimers::UPDATE_TIME,			std::move(update_time)));
+			stop_watch.emplace(std::make_pair(DefaultTimers::INPUT_TIME,				std::move(input_time)));
+			stop_watch.emplace(std::make_pair(DefaultTimers::RENDER_TIME,			std::move(render_time)));
+			stop_watch.emplace(std::make_pair(DefaultTimers::FRAME_TIME,				std::move(frame_time)));
 
 			return stop_watch;
 		}
 
 	public:
-		StandardTimeManager(mt::Engine& engine, std::error_condition& _alarm_manager_error) noexcept;
+		StandardTimeManager(
+			mt::Engine& engine,
+			std::error_condition& _alarm_manager_error,
+			std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource()
+		) noexcept;
 
 		virtual void resume() noexcept override;		// Call to unpaused.
 		virtual void pause() noexcept override;			// Call to pause.
@@ -227,6 +283,11 @@ export namespace mt::time
 			setTickFunction(&_initiate_shut_down_tick_function);
 		};
 
+		[[nodiscard]] virtual const FrameTimeReport* getFrameTimeReport() const noexcept override
+		{
+			return _standard_tick_function.getFrameTimeReport();
+		}
+
 		virtual StopWatch* findStopWatch(std::string_view name) override
 		{
 			auto find = _stop_watches.find(name);
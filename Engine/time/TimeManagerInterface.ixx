@@ -34,6 +34,14 @@ export namespace mt::time
 		inline static const std::string_view FRAME_TIME = "Frame Time"sv;
 	};
 
+	// The frame rate as of the last report, published by the tick thread. Read it while pinned to
+	// EpochDomain::global(), the tick thread retires a report when it publishes the next one.
+	struct FrameTimeReport
+	{
+		long long frames_rendered = 0;
+		std::chrono::steady_clock::duration average_frame_time = 1ns;
+	};
+
 	class TickFunction
 	{
 	public:
@@ -197,6 +205,9 @@ export namespace mt::time
 
 		virtual StopWatch* findStopWatch(std::string_view name) = 0;
 
+		// Null until the first report is published.
+		[[nodiscard]] virtual const FrameTimeReport* getFrameTimeReport() const noexcept = 0;
+
 		[[nodiscard]] bool isUpdatePaused() const noexcept { return _is_paused; }
 		//bool IsRenderPaused() const noexcept { return _is_render_paused; }
 	};
@@ -50,6 +50,7 @@ export namespace mt::time::model
 			, _task(task)
 			, _reset_interval(reset_interval)
 			, _alarm_repeats(alarm_repeats)
+			, _has_triggered(false)
 			, _is_paused(false)
 		{}
 
@@ -59,6 +60,7 @@ export namespace mt::time::model
 			, _task(&doNothing)
 			, _reset_interval(std::chrono::steady_clock::duration::min())
 			, _alarm_repeats(false)
+			, _has_triggered(false)
 			, _is_paused(true) 
 		{}
 			
@@ -66,24 +68,12 @@ export namespace mt::time::model
 
 		Alarm(const Alarm& other) noexcept = delete;
 		
-		Alarm(Alarm&& other) noexcept
-			: _alarm_time(std::move(other._alarm_time))
-			, _time_paused(std::move(other._time_paused))
-			, _task(std::move(other._task))
-			, _reset_interval(std::move(other._reset_interval))
-			, _alarm_repeats(std::move(other._alarm_repeats))
-			, _is_paused(std::move(other._is_paused))
-		{};
+		// Alarms live in a SlotMap, which moves them around when other alarms are erased, so moves must carry all state.
+		Alarm(Alarm&& other) noexcept = default;
 
 		Alarm& operator=(const Alarm& other) noexcept = delete;
 
-		Alarm& operator=(Alarm&& other)	noexcept
-		{
-			_alarm_time = std::move(other._alarm_time);
-			_task = other._task;
-
-			return *this;
-		};
+		Alarm& operator=(Alarm&& other)	noexcept = default;
 
 		bool operator<(const Alarm& other) const noexcept
 		{
@@ -3,6 +3,7 @@ module;
 
 #include <Windows.h>
 #include <windowsx.h>
+#include <psapi.h>
 
 export module Windows;
 
@@ -89,6 +90,12 @@ export namespace windows
 	using ::HBRUSH;
 	using ::PSTR;
 	using ::HANDLE;
+	using ::LONGLONG;
+	using ::LARGE_INTEGER;
+	using ::FILETIME;
+	using ::SYSTEM_INFO;
+	using ::TOKEN_PRIVILEGES;
+	using ::PROCESS_MEMORY_COUNTERS;
 
 	const LPWSTR IDC_ARROW_VALUE = IDC_ARROW;
 #undef IDC_ARROW
@@ -212,6 +219,10 @@ export namespace windows
 #undef DefWindowProc
 	auto& DefWindowProc = DefWindowProc_TEMP;
 
+	auto& GetProcessMemoryInfo_TEMP = GetProcessMemoryInfo;
+#undef GetProcessMemoryInfo
+	auto& GetProcessMemoryInfo = GetProcessMemoryInfo_TEMP;
+
 	using ::DefRawInputProc;
 	using ::GetRawInputData;
 	using ::PostQuitMessage;
@@ -227,6 +238,24 @@ export namespace windows
 	using ::ShowWindow;
 	using ::GetStockObject;
 	using ::GetSystemMetrics;
+	using ::GetCurrentProcess;
+	using ::GetThreadTimes;
+	using ::GetSystemInfo;
+	using ::OpenProcessToken;
+	using ::LookupPrivilegeValueW;
+	using ::AdjustTokenPrivileges;
+	using ::CloseHandle;
+	using ::VirtualAlloc;
+	using ::VirtualFree;
+	using ::VirtualLock;
+	using ::GetLargePageMinimum;
+	using ::CreateFileW;
+	using ::CreateFileMappingW;
+	using ::MapViewOfFile;
+	using ::UnmapViewOfFile;
+	using ::GetFileSizeEx;
+	using ::SetFilePointerEx;
+	using ::SetEndOfFile;
 	
 #undef CreateWindowW
 	HWND CreateWindowW(
@@ -445,4 +474,96 @@ export namespace windows
 	constexpr auto WM_XBUTTONUP_VALUE = WM_XBUTTONUP;
 #undef WM_XBUTTONUP
 	constexpr auto WM_XBUTTONUP = WM_XBUTTONUP_VALUE;
-}
\ No newline at end of file
+}
+
+// File, memory and process MACROs to constexpr
+export namespace windows
+{
+	const HANDLE INVALID_HANDLE_VALUE_VALUE = INVALID_HANDLE_VALUE;
+#undef INVALID_HANDLE_VALUE
+	const HANDLE INVALID_HANDLE_VALUE = INVALID_HANDLE_VALUE_VALUE;
+
+	constexpr auto FALSE_VALUE = FALSE;
+#undef FALSE
+	constexpr auto FALSE = FALSE_VALUE;
+
+	constexpr auto ERROR_SUCCESS_VALUE = ERROR_SUCCESS;
+#undef ERROR_SUCCESS
+	constexpr auto ERROR_SUCCESS = ERROR_SUCCESS_VALUE;
+
+	constexpr auto GENERIC_READ_VALUE = GENERIC_READ;
+#undef GENERIC_READ
+	constexpr auto GENERIC_READ = GENERIC_READ_VALUE;
+
+	constexpr auto GENERIC_WRITE_VALUE = GENERIC_WRITE;
+#undef GENERIC_WRITE
+	constexpr auto GENERIC_WRITE = GENERIC_WRITE_VALUE;
+
+	constexpr auto FILE_SHARE_READ_VALUE = FILE_SHARE_READ;
+#undef FILE_SHARE_READ
+	constexpr auto FILE_SHARE_READ = FILE_SHARE_READ_VALUE;
+
+	constexpr auto CREATE_ALWAYS_VALUE = CREATE_ALWAYS;
+#undef CREATE_ALWAYS
+	constexpr auto CREATE_ALWAYS = CREATE_ALWAYS_VALUE;
+
+	constexpr auto OPEN_EXISTING_VALUE = OPEN_EXISTING;
+#undef OPEN_EXISTING
+	constexpr auto OPEN_EXISTING = OPEN_EXISTING_VALUE;
+
+	constexpr auto FILE_ATTRIBUTE_NORMAL_VALUE = FILE_ATTRIBUTE_NORMAL;
+#undef FILE_ATTRIBUTE_NORMAL
+	constexpr auto FILE_ATTRIBUTE_NORMAL = FILE_ATTRIBUTE_NORMAL_VALUE;
+
+	constexpr auto FILE_BEGIN_VALUE = FILE_BEGIN;
+#undef FILE_BEGIN
+	constexpr auto FILE_BEGIN = FILE_BEGIN_VALUE;
+
+	constexpr auto PAGE_READONLY_VALUE = PAGE_READONLY;
+#undef PAGE_READONLY
+	constexpr auto PAGE_READONLY = PAGE_READONLY_VALUE;
+
+	constexpr auto PAGE_READWRITE_VALUE = PAGE_READWRITE;
+#undef PAGE_READWRITE
+	constexpr auto PAGE_READWRITE = PAGE_READWRITE_VALUE;
+
+	constexpr auto FILE_MAP_READ_VALUE = FILE_MAP_READ;
+#undef FILE_MAP_READ
+	constexpr auto FILE_MAP_READ = FILE_MAP_READ_VALUE;
+
+	constexpr auto FILE_MAP_WRITE_VALUE = FILE_MAP_WRITE;
+#undef FILE_MAP_WRITE
+	constexpr auto FILE_MAP_WRITE = FILE_MAP_WRITE_VALUE;
+
+	constexpr auto MEM_RESERVE_VALUE = MEM_RESERVE;
+#undef MEM_RESERVE
+	constexpr auto MEM_RESERVE = MEM_RESERVE_VALUE;
+
+	constexpr auto MEM_COMMIT_VALUE = MEM_COMMIT;
+#undef MEM_COMMIT
+	constexpr auto MEM_COMMIT = MEM_COMMIT_VALUE;
+
+	constexpr auto MEM_LARGE_PAGES_VALUE = MEM_LARGE_PAGES;
+#undef MEM_LARGE_PAGES
+	constexpr auto MEM_LARGE_PAGES = MEM_LARGE_PAGES_VALUE;
+
+	constexpr auto MEM_RELEASE_VALUE = MEM_RELEASE;
+#undef MEM_RELEASE
+	constexpr auto MEM_RELEASE = MEM_RELEASE_VALUE;
+
+	constexpr auto TOKEN_ADJUST_PRIVILEGES_VALUE = TOKEN_ADJUST_PRIVILEGES;
+#undef TOKEN_ADJUST_PRIVILEGES
+	constexpr auto TOKEN_ADJUST_PRIVILEGES = TOKEN_ADJUST_PRIVILEGES_VALUE;
+
+	constexpr auto TOKEN_QUERY_VALUE = TOKEN_QUERY;
+#undef TOKEN_QUERY
+	constexpr auto TOKEN_QUERY = TOKEN_QUERY_VALUE;
+
+	constexpr auto SE_PRIVILEGE_ENABLED_VALUE = SE_PRIVILEGE_ENABLED;
+#undef SE_PRIVILEGE_ENABLED
+	constexpr auto SE_PRIVILEGE_ENABLED = SE_PRIVILEGE_ENABLED_VALUE;
+
+	constexpr auto SE_LOCK_MEMORY_NAME_VALUE = SE_LOCK_MEMORY_NAME;
+#undef SE_LOCK_MEMORY_NAME
+	constexpr auto SE_LOCK_MEMORY_NAME = SE_LOCK_MEMORY_NAME_VALUE;
+}
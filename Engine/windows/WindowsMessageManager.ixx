@@ -7,6 +7,8 @@ export import Engine;
 export import WindowsMessageManagerInterface;
 export import WindowsMessage;
 
+import EpochReclamation;
+import FramePacket;
 import Windows;
 
 using namespace windows;
@@ -14,14 +16,31 @@ using namespace mt::error;
 
 export namespace mt::windows
 {
+	// What the tick thread wants done to the window. It holds state rather than one off requests, a packet that the
+	// message thread never sees is superseded by the next one without losing anything.
+	struct WindowCommandPacket
+	{
+		bool should_destroy_window = false;
+		bool should_show_cursor = true;
+	};
+
 	class WindowsMessageLoopTask : public mt::task::Task
 	{
 		mt::Engine& _engine;
 
 		std::atomic<bool> received_quit = false;
-		std::atomic<bool> should_destroy_window = false;
-		std::atomic<bool> should_toggle_cursor = false;
 		bool isCursorShowing = true;
+		bool has_destroyed_window = false;
+
+		// Written by the tick thread, the message thread applies the newest packet once per pump iteration.
+		WindowCommandPacket _window_commands{};
+		mt::memory::FramePacketExchange<WindowCommandPacket> _window_command_exchange{};
+
+		void _publishWindowCommands() noexcept
+		{
+			_window_command_exchange.getWritePacket() = _window_commands;
+			_window_command_exchange.publish();
+		}
 
 	public:
 		WindowsMessageLoopTask(mt::Engine& engine)
@@ -30,37 +49,45 @@ export namespace mt::windows
 
 		std::expected<void, std::error_condition> operator()() noexcept
 		{
-			long long last_frame_outputed = 0;
+			long long last_frame_outputed = -1;
 
-			auto frame_time = _engine.getTimeManager()->findStopWatch(mt::time::DefaultTimers::FRAME_TIME);
 			auto windows_message_time =
 				_engine.getTimeManager()->findStopWatch(mt::time::DefaultTimers::WINDOWS_MESSAGE_TIME);
 
+			// Without a participant the frame rate is not reported, nothing else reads shared memory through it.
+			auto epoch_participant = mt::memory::EpochDomain::global().registerParticipant();
+
 			// This can fail in theory, but I don't want to crash if it does.
 			HRESULT hr = SetThreadDescription(GetCurrentThread(),L"mt::Engine Windows Message Thread");
 			// TODO Check this result and do something
 
 			while (!received_quit)
 			{
-				auto last_frame_rendered = _engine.getRenderer()->getFramesRendered();
-
-				if (last_frame_rendered % 1440 == 0 && last_frame_outputed != last_frame_rendered)
+				if (epoch_participant)
 				{
-					last_frame_outputed = last_frame_rendered;
+					// The tick thread may replace the report at any time, the pin keeps this one alive.
+					[[maybe_unused]] auto epoch_guard = epoch_participant->pin();
+
+					if (auto report = _engine.getTimeManager()->getFrameTimeReport();
+						report && report->frames_rendered != last_frame_outputed
+					)
+					{
+						last_frame_outputed = report->frames_rendered;
 
-					std::chrono::steady_clock::duration average = frame_time->getAverageTaskInterval();
+						std::chrono::steady_clock::duration average = report->average_frame_time;
 
-					OutputDebugString(
-						(std::to_wstring(_engine.getRenderer()->getFramesRendered()) + L" frame number : ").c_str()
-					);
+						OutputDebugString((std::to_wstring(report->frames_rendered) + L" frame number : ").c_str());
 
-					OutputDebugString(
-						(std::to_wstring(static_cast<long double>(average.count() / 1'000'000.0)) + L" ns : ").c_str()
-					);
+						OutputDebugString(
+							(std::to_wstring(static_cast<long double>(average.count() / 1'000'000.0)) + L" ns : ")
+								.c_str()
+						);
 
-					OutputDebugString(
-						(std::to_wstring(1'000'000'000.0 / static_cast<double>(average.count())) + L" FPS\n").c_str()
-					);
+						OutputDebugString(
+							(std::to_wstring(1'000'000'000.0 / static_cast<double>(average.count())) + L" FPS\n")
+								.c_str()
+						);
+					}
 				}
 
 				windows_message_time->startTask();
@@ -80,15 +107,20 @@ export namespace mt::windows
 					}
 				}
 
+				_engine.getInputManager()->publishInput();
+
 				windows_message_time->finishTask();
 
+				_window_command_exchange.update();
+				const auto& window_commands = _window_command_exchange.getReadPacket();
+
 				if (auto handle = _engine.getWindowManager()->getWindow()->getHandle();
-					handle && should_destroy_window.load()
+					handle && window_commands.should_destroy_window && !has_destroyed_window
 				)
 				{
 					// This has to be done on the same thread that created the window. hence the design.
 					if (auto result = DestroyWindow(static_cast<HWND>(handle)); result != 0) {
-						should_destroy_window.store(false);
+						has_destroyed_window = true;
 					}
 					else
 					{
@@ -97,11 +129,10 @@ export namespace mt::windows
 					}
 				}
 
-				if (should_toggle_cursor)
+				if (window_commands.should_show_cursor != isCursorShowing)
 				{
-					isCursorShowing = !isCursorShowing;
+					isCursorShowing = window_commands.should_show_cursor;
 					ShowCursor(isCursorShowing);
-					should_toggle_cursor.store(false);
 				}
 			};
 
@@ -109,9 +140,21 @@ export namespace mt::windows
 			return {};
 		}
 
-		void destroyMainWindow() { should_destroy_window.store(true); }
+		// Tick thread only.
+		void destroyMainWindow()
+		{
+			_window_commands.should_destroy_window = true;
+			_publishWindowCommands();
+		}
+
 		bool hasReceivedQuit() { return received_quit.load(); }
-		void toggleShowCursor() { should_toggle_cursor.store(!should_toggle_cursor); }
+
+		// Tick thread only.
+		void toggleShowCursor()
+		{
+			_window_commands.should_show_cursor = !_window_commands.should_show_cursor;
+			_publishWindowCommands();
+		}
 	};
 
 	class WindowsMessageManager : public WindowsMessageManagerInterface
@@ -0,0 +1,334 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module AllocatorBenchmarks;
+
+import std;
+
+import Alarm;
+import BenchmarkOutput;
+import FrameArena;
+import InputModel;
+import ObjectPool;
+import RenderItem;
+import ThreadingPolicy;
+
+using namespace mt::memory;
+
+namespace mt::benchmarks
+{
+	// Stand in for an engine type, same size and alignment but trivially constructible, so the allocators are all
+	// measured doing the same work.
+	template<std::size_t size, std::size_t alignment>
+	struct Payload
+	{
+		alignas(alignment) std::array<std::byte, size> bytes;
+	};
+
+	using mt::input::model::InputMessage;
+	using mt::renderer::RenderItem;
+	using mt::time::model::Alarm;
+
+	using InputMessagePayload = Payload<sizeof(InputMessage), alignof(InputMessage)>;
+	using AlarmPayload = Payload<sizeof(Alarm), alignof(Alarm)>;
+	using RenderItemPayload = Payload<sizeof(RenderItem), alignof(RenderItem)>;
+
+	constexpr std::size_t LIVE_OBJECTS = 1024;
+	constexpr std::size_t POOL_CAPACITY = LIVE_OBJECTS * 2;
+
+	// Every allocator is adapted to the same raw pointer interface. clear() frees everything that is live at once.
+
+	template<typename T>
+	class NewDeleteAllocator
+	{
+	public:
+		static constexpr std::string_view NAME = "new/delete";
+		static constexpr bool IS_THREAD_SAFE = true;
+		static constexpr bool CAN_FREE_INDIVIDUALLY = true;
+
+		[[nodiscard]] T* allocate() noexcept { return new (std::nothrow) T; }
+
+		void deallocate(T* pointer) noexcept { delete pointer; }
+
+		void clear(std::span<T*> pointers) noexcept
+		{
+			for (auto pointer : pointers) delete pointer;
+		}
+	};
+
+	template<typename T, typename ThreadingPolicy>
+	class ObjectPoolAllocator
+	{
+		using Pool = ObjectPool<T, POOL_CAPACITY, ThreadingPolicy>;
+
+		std::error_condition _error;
+		std::unique_ptr<Pool> _pool = std::make_unique<Pool>(_error);
+
+	public:
+		static constexpr std::string_view NAME = ThreadingPolicy::IS_LOCK_FREE
+			? "ObjectPool<LockFree>"
+			: ThreadingPolicy::IS_THREAD_SAFE ? "ObjectPool<Mutex>" : "ObjectPool<SingleThreaded>";
+		static constexpr bool IS_THREAD_SAFE = ThreadingPolicy::IS_THREAD_SAFE;
+		static constexpr bool CAN_FREE_INDIVIDUALLY = true;
+
+		[[nodiscard]] T* allocate() noexcept { return _pool->allocate().release(); }
+
+		void deallocate(T* pointer) noexcept
+		{
+			typename Pool::unique_ptr_t{pointer, typename Pool::Deleter{*_pool}}.reset();
+		}
+
+		void clear(std::span<T*>) noexcept { _pool->reset(); }
+	};
+
+	template<typename T, typename Resource>
+	class PoolResourceAllocator
+	{
+		Resource _resource;
+
+	public:
+		static constexpr std::string_view NAME = std::same_as<Resource, std::pmr::synchronized_pool_resource>
+			? "pmr::synchronized_pool_resource"
+			: "pmr::unsynchronized_pool_resource";
+		static constexpr bool IS_THREAD_SAFE = std::same_as<Resource, std::pmr::synchronized_pool_resource>;
+		static constexpr bool CAN_FREE_INDIVIDUALLY = true;
+
+		[[nodiscard]] T* allocate() noexcept { return new (_resource.allocate(sizeof(T), alignof(T))) T; }
+
+		void deallocate(T* pointer) noexcept { _resource.deallocate(pointer, sizeof(T), alignof(T)); }
+
+		void clear(std::span<T*>) noexcept { _resource.release(); }
+	};
+
+	template<typename T>
+	class FrameArenaAllocator
+	{
+		std::error_condition _error;
+		FrameArena _arena{1, POOL_CAPACITY * sizeof(T) * 2, _error};
+
+	public:
+		static constexpr std::string_view NAME = "FrameArena";
+		static constexpr bool IS_THREAD_SAFE = false;
+		static constexpr bool CAN_FREE_INDIVIDUALLY = false;
+
+		[[nodiscard]] T* allocate() noexcept { return new (_arena.allocate(sizeof(T), alignof(T))) T; }
+
+		void clear(std::span<T*>) noexcept { _arena.beginFrame(0); }
+	};
+
+	struct Result
+	{
+		std::string_view workload;
+		std::string_view allocator;
+		std::string_view object;
+		std::size_t object_size;
+		std::size_t operations;
+		std::chrono::steady_clock::duration elapsed;
+	};
+
+	void printResult(const Result& result) noexcept
+	{
+		const auto case_name = std::format("{}/{}/{}", result.workload, result.allocator, result.object);
+
+		printRow("allocator", case_name, "object size", result.object_size);
+		printRow("allocator", case_name, "operations", result.operations);
+		printRow(
+			"allocator",
+			case_name,
+			"ns/op",
+			std::chrono::duration<double, std::nano>(result.elapsed).count() / static_cast<double>(result.operations)
+		);
+	}
+
+	template<typename Function>
+	std::chrono::steady_clock::duration timeWorkload(Function&& function) noexcept
+	{
+		const auto started = std::chrono::steady_clock::now();
+		function();
+		return std::chrono::steady_clock::now() - started;
+	}
+
+	// Allocates a batch and frees it newest first, the pattern of scratch objects in a function.
+	template<typename Allocator, typename T>
+	std::size_t runLifo(Allocator& allocator, std::size_t iterations) noexcept
+	{
+		constexpr std::size_t BATCH_SIZE = 64;
+
+		std::array<T*, BATCH_SIZE> batch{};
+
+		for (auto iteration = std::size_t{0}; iteration < iterations; ++iteration)
+		{
+			for (auto& pointer : batch) pointer = allocator.allocate();
+
+			if constexpr (Allocator::CAN_FREE_INDIVIDUALLY)
+			{
+				for (auto pointer = batch.rbegin(); pointer != batch.rend(); ++pointer) allocator.deallocate(*pointer);
+			}
+			else
+			{
+				allocator.clear(batch);
+			}
+		}
+
+		return iterations * BATCH_SIZE * 2;
+	}
+
+	// Frees and allocates at random positions in a set of live objects, the pattern of alarms and render items.
+	template<typename Allocator, typename T>
+	std::size_t runRandom(Allocator& allocator, std::size_t iterations) noexcept
+	{
+		std::array<T*, LIVE_OBJECTS> live{};
+		std::minstd_rand random{42};
+		std::uniform_int_distribution<std::size_t> index{0, LIVE_OBJECTS - 1};
+
+		for (auto iteration = std::size_t{0}; iteration < iterations; ++iteration)
+		{
+			auto& pointer = live[index(random)];
+
+			if (pointer)
+			{
+				allocator.deallocate(pointer);
+				pointer = nullptr;
+			}
+			else
+			{
+				pointer = allocator.allocate();
+			}
+		}
+
+		for (auto pointer : live) if (pointer) allocator.deallocate(pointer);
+
+		return iterations;
+	}
+
+	// Fills a frame's worth of objects and frees them all at once.
+	template<typename Allocator, typename T>
+	std::size_t runBulkClear(Allocator& allocator, std::size_t iterations) noexcept
+	{
+		std::vector<T*> live(LIVE_OBJECTS);
+
+		for (auto iteration = std::size_t{0}; iteration < iterations; ++iteration)
+		{
+			for (auto& pointer : live) pointer = allocator.allocate();
+
+			allocator.clear(live);
+		}
+
+		return iterations * LIVE_OBJECTS;
+	}
+
+	// Objects are allocated on one thread and freed on another, the pattern of the input message handoff.
+	template<typename Allocator, typename T>
+	std::size_t runProducerConsumer(Allocator& allocator, std::size_t iterations) noexcept
+	{
+		constexpr std::size_t RING_SIZE = 256;
+
+		std::array<std::atomic<T*>, RING_SIZE> ring{};
+
+		auto consumer = std::jthread([&]() noexcept {
+			for (auto i = std::size_t{0}; i < iterations; ++i)
+			{
+				auto& slot = ring[i % RING_SIZE];
+
+				T* pointer;
+				while ((pointer = slot.load(std::memory_order_acquire)) == nullptr);
+
+				slot.store(nullptr, std::memory_order_relaxed);
+				allocator.deallocate(pointer);
+			}
+		});
+
+		for (auto i = std::size_t{0}; i < iterations;)
+		{
+			auto& slot = ring[i % RING_SIZE];
+
+			if (slot.load(std::memory_order_acquire) != nullptr) continue;
+
+			if (auto pointer = allocator.allocate(); pointer)
+			{
+				slot.store(pointer, std::memory_order_release);
+				++i;
+			}
+		}
+
+		consumer.join();
+
+		return iterations * 2;
+	}
+
+	template<template<typename> typename Allocator, typename T>
+	void runAllocator(std::string_view object, std::size_t iterations) noexcept
+	{
+		using AllocatorType = Allocator<T>;
+
+		auto run = [&](std::string_view workload, auto&& workload_function) noexcept {
+			auto allocator = std::make_unique<AllocatorType>();
+
+			std::size_t operations = 0;
+			const auto elapsed = timeWorkload([&]() noexcept { operations = workload_function(*allocator); });
+
+			printResult(Result{workload, AllocatorType::NAME, object, sizeof(T), operations, elapsed});
+		};
+
+		run("lifo", [&](AllocatorType& allocator) noexcept {
+			return runLifo<AllocatorType, T>(allocator, iterations / 64);
+		});
+
+		if constexpr (AllocatorType::CAN_FREE_INDIVIDUALLY)
+		{
+			run("random", [&](AllocatorType& allocator) noexcept {
+				return runRandom<AllocatorType, T>(allocator, iterations);
+			});
+		}
+
+		if constexpr (AllocatorType::CAN_FREE_INDIVIDUALLY && AllocatorType::IS_THREAD_SAFE)
+		{
+			run("producer consumer", [&](AllocatorType& allocator) noexcept {
+				return runProducerConsumer<AllocatorType, T>(allocator, iterations);
+			});
+		}
+
+		run("bulk clear", [&](AllocatorType& allocator) noexcept {
+			return runBulkClear<AllocatorType, T>(allocator, iterations / LIVE_OBJECTS);
+		});
+	}
+
+	template<typename T>
+	using SingleThreadedObjectPoolAllocator = ObjectPoolAllocator<T, SingleThreadedPolicy>;
+
+	template<typename T>
+	using MutexObjectPoolAllocator = ObjectPoolAllocator<T, MutexPolicy>;
+
+	template<typename T>
+	using LockFreeObjectPoolAllocator = ObjectPoolAllocator<T, LockFreePolicy>;
+
+	template<typename T>
+	using UnsynchronizedPoolAllocator = PoolResourceAllocator<T, std::pmr::unsynchronized_pool_resource>;
+
+	template<typename T>
+	using SynchronizedPoolAllocator = PoolResourceAllocator<T, std::pmr::synchronized_pool_resource>;
+
+	template<typename T>
+	void runObject(std::string_view object, std::size_t iterations) noexcept
+	{
+		runAllocator<NewDeleteAllocator, T>(object, iterations);
+		runAllocator<SingleThreadedObjectPoolAllocator, T>(object, iterations);
+		runAllocator<MutexObjectPoolAllocator, T>(object, iterations);
+		runAllocator<LockFreeObjectPoolAllocator, T>(object, iterations);
+		runAllocator<UnsynchronizedPoolAllocator, T>(object, iterations);
+		// The unsynchronized resource can not be shared between threads, this one stands in for it across threads.
+		runAllocator<SynchronizedPoolAllocator, T>(object, iterations);
+		runAllocator<FrameArenaAllocator, T>(object, iterations);
+	}
+}
+
+export namespace mt::benchmarks
+{
+	// Prints the cost of every workload with every allocator and object size.
+	void runAllocatorBenchmarks() noexcept
+	{
+		constexpr std::size_t ITERATIONS = 1 << 20;
+
+		runObject<InputMessagePayload>("InputMessage", ITERATIONS);
+		runObject<AlarmPayload>("Alarm", ITERATIONS);
+		runObject<RenderItemPayload>("RenderItem", ITERATIONS);
+	}
+}
@@ -0,0 +1,141 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module BackingStoreBenchmarks;
+
+import std;
+
+import BackingStore;
+import BenchmarkOutput;
+import InputModel;
+import ObjectPool;
+import ThreadingPolicy;
+import Windows;
+
+using namespace mt::input::model;
+using namespace mt::memory;
+using namespace windows;
+
+namespace mt::benchmarks
+{
+	[[nodiscard]] std::size_t getPageFaultCount() noexcept
+	{
+		PROCESS_MEMORY_COUNTERS counters{};
+		counters.cb = sizeof(counters);
+
+		return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PageFaultCount : 0;
+	}
+
+	struct PhaseResult
+	{
+		std::size_t page_faults;
+		std::size_t operations;
+		std::chrono::steady_clock::duration elapsed;
+
+		[[nodiscard]] double nanosecondsPerOperation() const noexcept
+		{
+			return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(operations);
+		}
+	};
+
+	template<typename Function>
+	PhaseResult measure(std::size_t operations, Function&& function) noexcept
+	{
+		const auto page_faults = getPageFaultCount();
+		const auto started = std::chrono::steady_clock::now();
+
+		function();
+
+		const auto elapsed = std::chrono::steady_clock::now() - started;
+
+		return PhaseResult{getPageFaultCount() - page_faults, operations, elapsed};
+	}
+
+	void printResult(std::string_view backing_store_name, std::string_view phase, const PhaseResult& result) noexcept
+	{
+		const auto case_name = std::format("{}/{}", backing_store_name, phase);
+
+		printRow("backing store", case_name, "page faults", result.page_faults);
+		printRow("backing store", case_name, "operations", result.operations);
+		printRow("backing store", case_name, "ns/op", result.nanosecondsPerOperation());
+	}
+
+	// The first frame fills a pool of input messages, which is where a malloc backed pool takes its page faults.
+	// Steady state reads cache lines at random across a large buffer, there are far more pages than TLB entries so
+	// the cost per read is dominated by TLB misses, which large pages remove. Hardware TLB counters are not
+	// available to an unprivileged process, so the page fault count and the cost per read stand in for them.
+	template<BackingStorePolicy BackingStore>
+	void runBackingStore(std::string_view backing_store_name) noexcept
+	{
+		constexpr std::size_t POOL_SIZE = 1 << 16;
+		constexpr std::size_t BUFFER_BYTES = std::size_t{256} << 20;
+		constexpr std::size_t CACHE_LINE = std::hardware_destructive_interference_size;
+		constexpr std::size_t READS = 1 << 24;
+
+		using Pool = ObjectPool<InputMessage, POOL_SIZE, MutexPolicy, BackingStore>;
+
+		{
+			std::error_condition error;
+			std::unique_ptr<Pool> pool;
+
+			printResult(backing_store_name, "pool construction", measure(1, [&]() noexcept {
+				pool = std::make_unique<Pool>(error);
+			}));
+
+			if (error)
+			{
+				std::println(std::cerr, "Unable to allocate pool: {}", error.message());
+				return;
+			}
+
+			std::vector<typename Pool::unique_ptr_t> messages;
+			messages.reserve(POOL_SIZE);
+
+			printResult(backing_store_name, "first frame", measure(POOL_SIZE, [&]() noexcept {
+				for (auto i = std::size_t{0}; i < POOL_SIZE; ++i) messages.push_back(pool->allocate());
+			}));
+
+			messages.clear();
+
+			printResult(backing_store_name, "second frame", measure(POOL_SIZE, [&]() noexcept {
+				for (auto i = std::size_t{0}; i < POOL_SIZE; ++i) messages.push_back(pool->allocate());
+			}));
+		}
+
+		auto buffer = static_cast<std::byte*>(BackingStore::allocate(BUFFER_BYTES));
+
+		if (buffer == nullptr)
+		{
+			std::println(std::cerr, "Unable to allocate {} bytes.", BUFFER_BYTES);
+			return;
+		}
+
+		printResult(backing_store_name, "first touch", measure(BUFFER_BYTES / CACHE_LINE, [&]() noexcept {
+			for (auto offset = std::size_t{0}; offset < BUFFER_BYTES; offset += CACHE_LINE)
+			{
+				buffer[offset] = std::byte{1};
+			}
+		}));
+
+		std::minstd_rand random{42};
+		std::uniform_int_distribution<std::size_t> line{0, BUFFER_BYTES / CACHE_LINE - 1};
+		std::vector<std::size_t> offsets(READS);
+		for (auto& offset : offsets) offset = line(random) * CACHE_LINE;
+
+		volatile std::byte sink{};
+		printResult(backing_store_name, "steady state random read", measure(READS, [&]() noexcept {
+			for (auto offset : offsets) sink = buffer[offset];
+		}));
+
+		BackingStore::deallocate(buffer);
+	}
+}
+
+export namespace mt::benchmarks
+{
+	void runBackingStoreBenchmarks() noexcept
+	{
+		runBackingStore<MallocBackingStore>("Malloc");
+		runBackingStore<PrefaultedBackingStore>("Prefaulted");
+		runBackingStore<LockedBackingStore>("Locked");
+		runBackingStore<LargePageBackingStore>("LargePage");
+	}
+}
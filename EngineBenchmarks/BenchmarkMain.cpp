@@ -0,0 +1,20 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+import std;
+
+import AllocatorBenchmarks;
+import BackingStoreBenchmarks;
+import BenchmarkOutput;
+import EventQueueBenchmarks;
+import ObjectPoolBenchmarks;
+
+int main()
+{
+	mt::benchmarks::printHeader();
+
+	mt::benchmarks::runAllocatorBenchmarks();
+	mt::benchmarks::runObjectPoolContentionBenchmarks();
+	mt::benchmarks::runBackingStoreBenchmarks();
+	mt::benchmarks::runEventQueueWakeupBenchmarks();
+
+	return 0;
+}
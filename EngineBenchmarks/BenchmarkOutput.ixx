@@ -0,0 +1,24 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module BenchmarkOutput;
+
+import std;
+
+export namespace mt::benchmarks
+{
+	// Every suite prints to one CSV table on stdout with a row per measured value, so a whole run loads as a single
+	// table and can be diffed across commits. A case is what was measured, its parts separated by slashes. Errors go
+	// to stderr and never interleave with the table.
+	void printHeader() noexcept
+	{
+		std::println("suite,case,metric,value");
+	}
+
+	template<typename Value> requires std::is_arithmetic_v<Value>
+	void printRow(std::string_view suite, std::string_view case_name, std::string_view metric, Value value) noexcept
+	{
+		if constexpr (std::is_floating_point_v<Value>)
+			std::println("{},{},{},{:.2f}", suite, case_name, metric, value);
+		else
+			std::println("{},{},{},{}", suite, case_name, metric, value);
+	}
+}
@@ -0,0 +1,148 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module EventQueueBenchmarks;
+
+import std;
+
+import BenchmarkOutput;
+import Event;
+import EventHandlerInterface;
+import EventQueue;
+import Windows;
+
+using namespace std::literals;
+using namespace mt::event;
+using namespace windows;
+
+namespace mt::benchmarks
+{
+	constexpr std::size_t WAKEUP_SAMPLES = 2000;
+	// Long enough for the consumer to have gone back to sleep before the next event.
+	constexpr auto WAKEUP_INTERVAL = 500us;
+	constexpr auto IDLE_DURATION = 200ms;
+
+	// Records how long after it was triggered every event reached its handler.
+	struct LatencyEventHandler : public EventHandler<std::int64_t>
+	{
+		std::vector<std::int64_t> latencies = std::vector<std::int64_t>(WAKEUP_SAMPLES);
+		std::atomic<std::size_t> count = 0;
+
+		void operator()(std::int64_t trigger_time) noexcept override
+		{
+			const auto index = count.load(std::memory_order_relaxed);
+
+			latencies[index] = std::chrono::steady_clock::now().time_since_epoch().count() - trigger_time;
+
+			count.store(index + 1, std::memory_order_release);
+			count.notify_all();
+		}
+
+		void waitForCount(std::size_t expected_count) noexcept
+		{
+			for (auto current = count.load(std::memory_order_acquire);
+				current != expected_count;
+				current = count.load(std::memory_order_acquire)
+			)
+			{
+				count.wait(current, std::memory_order_acquire);
+			}
+		}
+	};
+
+	[[nodiscard]] std::chrono::nanoseconds getThreadCpuTime(std::jthread& thread) noexcept
+	{
+		FILETIME creation_time{}, exit_time{}, kernel_time{}, user_time{};
+
+		if (!GetThreadTimes(thread.native_handle(), &creation_time, &exit_time, &kernel_time, &user_time)) return {};
+
+		const auto to_ticks = [](FILETIME time) noexcept {
+			return (static_cast<std::uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+		};
+
+		// FILETIME counts 100ns intervals.
+		return std::chrono::nanoseconds((to_ticks(kernel_time) + to_ticks(user_time)) * 100);
+	}
+
+	// Triggers an event every WAKEUP_INTERVAL and waits for it to be handled, so the consumer finds the queue empty
+	// before every one and the latency includes waking it up. Then leaves the consumer idle for IDLE_DURATION and
+	// reports how much CPU time it used meanwhile.
+	template<typename Consumer>
+	void runWakeup(std::string_view consumer_name, Consumer&& consumer_body) noexcept
+	{
+		EventQueue event_queue{1 << 16, EventQueueMode::LOCK_FREE};
+
+		Event<std::int64_t> event = Event<std::int64_t>(event_queue, L"Wakeup");
+		LatencyEventHandler event_handler;
+		event.registerEventHandler(&event_handler);
+
+		std::jthread consumer([&event_queue, &consumer_body](std::stop_token stop_token) noexcept {
+			consumer_body(event_queue, stop_token);
+		});
+		event_queue.bindConsumerThread(consumer.get_id());
+
+		for (auto i = std::size_t{0}; i < WAKEUP_SAMPLES; ++i)
+		{
+			std::this_thread::sleep_for(WAKEUP_INTERVAL);
+
+			if (!event.trigger(std::chrono::steady_clock::now().time_since_epoch().count()))
+			{
+				std::println(std::cerr, "Unable to trigger the wakeup event.");
+				return;
+			}
+
+			event_handler.waitForCount(i + 1);
+		}
+
+		const auto cpu_time_before_idle = getThreadCpuTime(consumer);
+		std::this_thread::sleep_for(IDLE_DURATION);
+		const auto idle_cpu_time = getThreadCpuTime(consumer) - cpu_time_before_idle;
+
+		consumer.request_stop();
+		consumer.join();
+
+		auto& latencies = event_handler.latencies;
+		std::ranges::sort(latencies);
+
+		const auto to_microseconds = [](std::int64_t ticks) noexcept {
+			return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::duration(ticks)).count();
+		};
+
+		printRow("event queue wakeup", consumer_name, "p50 us", to_microseconds(latencies[latencies.size() / 2]));
+		printRow(
+			"event queue wakeup", consumer_name, "p99 us", to_microseconds(latencies[latencies.size() * 99 / 100])
+		);
+		printRow("event queue wakeup", consumer_name, "max us", to_microseconds(latencies.back()));
+		printRow(
+			"event queue wakeup",
+			consumer_name,
+			"idle cpu ms",
+			std::chrono::duration<double, std::milli>(idle_cpu_time).count()
+		);
+	}
+}
+
+export namespace mt::benchmarks
+{
+	// Wakeup latency of a consumer thread that sleeps on its queue, against consumers that poll it.
+	void runEventQueueWakeupBenchmarks() noexcept
+	{
+		runWakeup("atomic wait", [](EventQueue& event_queue, std::stop_token stop_token) noexcept {
+			event_queue.runConsumer(stop_token);
+		});
+
+		runWakeup("poll 1ms", [](EventQueue& event_queue, std::stop_token stop_token) noexcept {
+			while (!stop_token.stop_requested())
+			{
+				event_queue.processTriggeredEvents();
+				std::this_thread::sleep_for(1ms);
+			}
+		});
+
+		runWakeup("spin", [](EventQueue& event_queue, std::stop_token stop_token) noexcept {
+			while (!stop_token.stop_requested())
+			{
+				event_queue.processTriggeredEvents();
+				std::this_thread::yield();
+			}
+		});
+	}
+}
@@ -0,0 +1,124 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+export module ObjectPoolBenchmarks;
+
+import std;
+
+import BenchmarkOutput;
+import InputModel;
+import LockFreeObjectPool;
+import ObjectPool;
+import ThreadingPolicy;
+
+using namespace mt::input::model;
+using namespace mt::memory;
+
+export namespace mt::benchmarks
+{
+	struct ContentionResult
+	{
+		std::string_view pool_name;
+		unsigned int thread_count;
+		std::size_t operations;
+		std::chrono::steady_clock::duration elapsed;
+
+		[[nodiscard]] double nanosecondsPerOperation() const noexcept
+		{
+			return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(operations);
+		}
+	};
+
+	// Every thread repeatedly allocates a small batch of objects and then releases it, so all threads hammer the
+	// shared free structure of the pool at the same time.
+	template<typename Pool>
+	ContentionResult runContention(
+		std::string_view pool_name, Pool& pool, unsigned int thread_count, std::size_t iterations_per_thread
+	) noexcept
+	{
+		constexpr std::size_t BATCH_SIZE = 8;
+
+		std::atomic<std::size_t> operations = 0;
+		std::latch start{thread_count + 1};
+
+		std::vector<std::jthread> threads;
+		threads.reserve(thread_count);
+
+		for (auto thread_index = 0u; thread_index < thread_count; thread_index++)
+		{
+			threads.emplace_back([&]() {
+				std::vector<typename Pool::unique_ptr_t> batch;
+				batch.reserve(BATCH_SIZE);
+
+				std::size_t local_operations = 0;
+
+				start.arrive_and_wait();
+
+				for (auto iteration = std::size_t{0}; iteration < iterations_per_thread; iteration++)
+				{
+					for (auto i = 0u; i < BATCH_SIZE; i++)
+					{
+						if (auto pointer = pool.allocate(InputType(), std::chrono::steady_clock::now()); pointer)
+						{
+							batch.push_back(std::move(pointer));
+							++local_operations;
+						}
+					}
+
+					local_operations += batch.size();
+					batch.clear();
+				}
+
+				operations.fetch_add(local_operations, std::memory_order_relaxed);
+			});
+		}
+
+		const auto started = std::chrono::steady_clock::now();
+		start.arrive_and_wait();
+		threads.clear();
+		const auto elapsed = std::chrono::steady_clock::now() - started;
+
+		return ContentionResult{pool_name, thread_count, operations.load(), elapsed};
+	}
+
+	void runObjectPoolContentionBenchmarks() noexcept
+	{
+		constexpr std::size_t POOL_SIZE = 2048;
+		constexpr std::size_t ITERATIONS_PER_THREAD = 100'000;
+		constexpr std::size_t MAGAZINE_SIZE = 32;
+
+		const auto max_threads = std::max(2u, std::thread::hardware_concurrency());
+
+		for (auto thread_count = 1u; thread_count <= max_threads; thread_count++)
+		{
+			std::error_condition error;
+
+			auto mutex_pool = std::make_unique<ObjectPool<InputMessage, POOL_SIZE>>(error);
+			auto lock_free_object_pool = std::make_unique<ObjectPool<InputMessage, POOL_SIZE, LockFreePolicy>>(error);
+			auto lock_free_pool = std::make_unique<LockFreeObjectPool<InputMessage, POOL_SIZE>>(error);
+			auto magazine_pool = std::make_unique<LockFreeObjectPool<InputMessage, POOL_SIZE, MAGAZINE_SIZE>>(error);
+
+			if (error)
+			{
+				std::println(std::cerr, "Unable to allocate pools: {}", error.message());
+				return;
+			}
+
+			for (const auto& result : {
+				runContention("ObjectPool", *mutex_pool, thread_count, ITERATIONS_PER_THREAD),
+				runContention("ObjectPool<LockFree>", *lock_free_object_pool, thread_count, ITERATIONS_PER_THREAD),
+				runContention("LockFreeObjectPool", *lock_free_pool, thread_count, ITERATIONS_PER_THREAD),
+				runContention("LockFreeObjectPool+Magazines", *magazine_pool, thread_count, ITERATIONS_PER_THREAD)
+			})
+			{
+				const auto case_name = std::format("{}/{} threads", result.pool_name, result.thread_count);
+
+				printRow("object pool contention", case_name, "operations", result.operations);
+				printRow("object pool contention", case_name, "ns/op", result.nanosecondsPerOperation());
+			}
+
+			const auto case_name = std::format("LockFreeObjectPool+Magazines/{} threads", thread_count);
+			const auto statistics = magazine_pool->getMagazineStatistics();
+			printRow("object pool contention", case_name, "magazine refills", statistics.refills);
+			printRow("object pool contention", case_name, "magazine flushes", statistics.flushes);
+		}
+	}
+}
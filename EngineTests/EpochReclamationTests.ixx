@@ -0,0 +1,112 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+export module EpochReclamationTests;
+
+import std;
+
+import EpochReclamation;
+
+using namespace mt::memory;
+
+namespace
+{
+	void countReclaim(void* context, void*) noexcept
+	{
+		++*static_cast<int*>(context);
+	}
+}
+
+TEST_CASE("Epoch Domain Reclaims Two Epochs After Retiring", "[memory]")
+{
+	EpochDomain domain;
+	int reclaimed = 0;
+
+	domain.retire(nullptr, &reclaimed, countReclaim);
+	REQUIRE(1 == domain.getRetiredCount());
+
+	REQUIRE(domain.advance());
+	REQUIRE(0 == reclaimed);
+
+	REQUIRE(domain.advance());
+	REQUIRE(1 == reclaimed);
+	REQUIRE(0 == domain.getRetiredCount());
+}
+
+TEST_CASE("Epoch Domain Waits For Pinned Participants", "[memory]")
+{
+	EpochDomain domain;
+	int reclaimed = 0;
+
+	auto participant = domain.registerParticipant();
+	REQUIRE(participant);
+
+	{
+		auto guard = participant->pin();
+		REQUIRE(participant->isPinned());
+
+		domain.retire(nullptr, &reclaimed, countReclaim);
+
+		// The participant caught up with the first epoch, but is still pinned in it for the second.
+		REQUIRE(domain.advance());
+		REQUIRE(!domain.advance());
+		REQUIRE(!domain.advance());
+		REQUIRE(0 == reclaimed);
+	}
+
+	REQUIRE(!participant->isPinned());
+	REQUIRE(domain.advance());
+	REQUIRE(1 == reclaimed);
+}
+
+TEST_CASE("Epoch Domain Pins Nest", "[memory]")
+{
+	EpochDomain domain;
+
+	auto participant = domain.registerParticipant();
+
+	{
+		auto outer = participant->pin();
+		{
+			auto inner = participant->pin();
+		}
+		REQUIRE(participant->isPinned());
+	}
+
+	REQUIRE(!participant->isPinned());
+}
+
+TEST_CASE("Epoch Domain Has A Fixed Number Of Participants", "[memory]")
+{
+	EpochDomain domain;
+	std::vector<EpochParticipant> participants;
+
+	for (auto i = std::size_t{0}; i < EpochDomain::MAX_PARTICIPANTS; ++i)
+	{
+		auto participant = domain.registerParticipant();
+		REQUIRE(participant);
+		participants.push_back(std::move(*participant));
+	}
+
+	REQUIRE(!domain.registerParticipant());
+
+	// Unregistering frees the slot up again.
+	participants.pop_back();
+	REQUIRE(domain.registerParticipant());
+}
+
+TEST_CASE("Epoch Domain Deletes Retired Objects", "[memory]")
+{
+	EpochDomain domain;
+	auto shared = new std::shared_ptr<int>(std::make_shared<int>(1));
+	std::weak_ptr<int> watcher = *shared;
+
+	domain.retire(shared);
+	domain.advance();
+	REQUIRE(!watcher.expired());
+
+	domain.advance();
+	REQUIRE(watcher.expired());
+}
@@ -0,0 +1,188 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+export module EventManagerTests;
+
+import std;
+
+import Constants;
+import Error;
+import Event;
+import EventHandlerInterface;
+import EventManagerInterface;
+
+using namespace mt::error;
+using namespace mt::event;
+using namespace mt::utility;
+
+namespace
+{
+	// Records the thread every call was made on.
+	struct ThreadRecordingEventHandler : public EventHandler<int>
+	{
+		std::vector<std::thread::id> threads;
+
+		void operator()(int) noexcept override { threads.push_back(std::this_thread::get_id()); }
+	};
+
+	constexpr std::size_t QUEUE_COUNT = 8;
+	constexpr int EVENTS_PER_QUEUE = 100;
+
+	void requireEveryQueueIsDrained(EventDispatchMode dispatch_mode, std::size_t worker_count)
+	{
+		std::error_condition error;
+		EventManagerInterface event_manager{error, dispatch_mode, std::pmr::get_default_resource(), worker_count};
+		REQUIRE(!error);
+
+		std::vector<std::unique_ptr<Event<int>>> events;
+		std::vector<ThreadRecordingEventHandler> event_handlers(QUEUE_COUNT);
+
+		for (auto i = std::size_t{0}; i < QUEUE_COUNT; ++i)
+		{
+			auto event_queue = event_manager.createEventQueue(Name(std::format(L"Queue {}", i)), 4096);
+			REQUIRE(event_queue);
+
+			auto& event = events.emplace_back(std::make_unique<Event<int>>(**event_queue, L"Name"));
+			event->registerEventHandler(&event_handlers[i]);
+		}
+
+		for (auto frame = 0; frame < 3; ++frame)
+		{
+			for (auto& event : events)
+			{
+				for (auto i = 0; i < EVENTS_PER_QUEUE; ++i) REQUIRE(event->trigger(i));
+			}
+
+			event_manager.processEvents(std::chrono::steady_clock::now());
+
+			for (auto& event_handler : event_handlers)
+			{
+				REQUIRE(EVENTS_PER_QUEUE * (frame + 1) == event_handler.threads.size());
+			}
+		}
+	}
+}
+
+TEST_CASE("Event Manager Drains Every Queue Serially", "[events]")
+{
+	requireEveryQueueIsDrained(EventDispatchMode::SERIAL, 0);
+}
+
+TEST_CASE("Event Manager Drains Every Queue In Parallel", "[events]")
+{
+	requireEveryQueueIsDrained(EventDispatchMode::PARALLEL, 3);
+}
+
+TEST_CASE("Event Manager Drains Calling Thread Queues On The Calling Thread", "[events]")
+{
+	std::error_condition error;
+	EventManagerInterface event_manager{error, EventDispatchMode::PARALLEL, std::pmr::get_default_resource(), 3};
+
+	// Enough queues any thread may drain that the workers are woken.
+	REQUIRE(event_manager.createEventQueue(Name(L"Any 0"), 1024));
+	REQUIRE(0 == event_manager.getWorkerCount());
+
+	for (auto i = 1; i < 4; ++i) REQUIRE(event_manager.createEventQueue(Name(std::format(L"Any {}", i)), 1024));
+	REQUIRE(3 == event_manager.getWorkerCount());
+
+	auto event_queue = event_manager.createEventQueue(
+		Name(L"Renderer"), 1024, EventQueueMode::MUTEX, EventQueueAffinity::CALLING_THREAD
+	);
+	REQUIRE(event_queue);
+
+	Event<int> event = Event<int>(**event_queue, L"Name");
+	ThreadRecordingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	for (auto frame = 0; frame < 10; ++frame)
+	{
+		REQUIRE(event.trigger(frame));
+		event_manager.processEvents(std::chrono::steady_clock::now());
+	}
+
+	REQUIRE(10 == event_handler.threads.size());
+	REQUIRE(std::ranges::all_of(event_handler.threads, [](auto thread) {
+		return thread == std::this_thread::get_id();
+	}));
+}
+
+TEST_CASE("Event Manager Rejects Duplicate Queue Names", "[events]")
+{
+	std::error_condition error;
+	EventManagerInterface event_manager{error};
+
+	REQUIRE(event_manager.createEventQueue(Name(L"Queue"), 1024));
+	REQUIRE(!event_manager.createEventQueue(Name(L"Queue"), 1024));
+}
+
+TEST_CASE("Event Manager Finds Queues By Name", "[events]")
+{
+	std::error_condition error;
+	EventManagerInterface event_manager{error};
+
+	auto event_queue = event_manager.createEventQueue(Name(L"Queue"), 1024);
+	REQUIRE(event_queue);
+
+	auto found = event_manager.getEventQueue(Name(L"Queue"));
+	REQUIRE(found);
+	REQUIRE(*event_queue == *found);
+
+	auto missing = event_manager.getEventQueue(Name(L"Missing"));
+	REQUIRE(!missing);
+	REQUIRE(MakeErrorCondition(ErrorCode::EVENT_QUEUE_NOT_FOUND) == missing.error());
+}
+
+TEST_CASE("Event Manager Reports Queue Statistics By Name", "[events]")
+{
+	std::error_condition error;
+	EventManagerInterface event_manager{error};
+
+	auto event_queue = event_manager.createEventQueue(Name(L"Queue"), 1024);
+	REQUIRE(event_queue);
+
+	Event<int> event = Event<int>(**event_queue, L"Name");
+	ThreadRecordingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	REQUIRE(event.trigger(1));
+	REQUIRE(event.trigger(2));
+	event_manager.processEvents(std::chrono::steady_clock::now());
+
+	auto statistics = event_manager.getEventQueueStatistics(Name(L"Queue"));
+	REQUIRE(statistics);
+	REQUIRE((mt::HAS_EVENT_QUEUE_STATISTICS ? 2 : 0) == statistics->pushes);
+
+	REQUIRE(!event_manager.getEventQueueStatistics(Name(L"Missing")));
+
+	std::size_t queue_count = 0;
+	event_manager.forEachEventQueueStatistics([&queue_count](Name, const EventQueueStatistics&) noexcept {
+		++queue_count;
+	});
+	REQUIRE(1 == queue_count);
+}
+
+TEST_CASE("Event Manager Leaves Consumer Thread Queues To Their Consumer", "[events]")
+{
+	std::error_condition error;
+	EventManagerInterface event_manager{error};
+
+	auto event_queue = event_manager.createEventQueue(
+		Name(L"Consumer"), 1024, EventQueueMode::MUTEX, EventQueueAffinity::CONSUMER_THREAD
+	);
+	REQUIRE(event_queue);
+	(*event_queue)->bindConsumerThread();
+
+	Event<int> event = Event<int>(**event_queue, L"Name");
+	ThreadRecordingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	REQUIRE(event.trigger(1));
+	event_manager.processEvents(std::chrono::steady_clock::now());
+	REQUIRE(event_handler.threads.empty());
+
+	REQUIRE((*event_queue)->waitForEvents());
+	(*event_queue)->processTriggeredEvents();
+	REQUIRE(1 == event_handler.threads.size());
+}
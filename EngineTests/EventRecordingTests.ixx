@@ -0,0 +1,170 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+export module EventRecordingTests;
+
+import std;
+
+import Event;
+import EventHandlerInterface;
+import EventPlayer;
+import EventQueue;
+import EventRecorder;
+
+using namespace std::literals;
+using namespace mt::event;
+
+namespace
+{
+	struct PointEventHandler : public EventHandler<int, int>
+	{
+		std::vector<std::pair<int, int>> points;
+
+		void operator()(int x, int y) noexcept override { points.emplace_back(x, y); }
+	};
+
+	struct CountingEventHandler : public EventHandler<>
+	{
+		int calls = 0;
+
+		void operator()() noexcept override { ++calls; }
+	};
+
+	[[nodiscard]] std::filesystem::path getLogPath(std::string_view test)
+	{
+		return std::filesystem::temp_directory_path() / std::format("mt_{}.events", test);
+	}
+
+	// Records two ticks of events, 16ms apart, starting at tick_time.
+	void recordSession(const std::filesystem::path& path, std::chrono::steady_clock::time_point tick_time)
+	{
+		std::error_condition error;
+		EventRecorder recorder{path, error};
+		REQUIRE(!error);
+
+		EventQueue event_queue;
+		event_queue.setRecorder(&recorder);
+
+		Event<int, int> moved = Event<int, int>(event_queue, L"Moved");
+		Event<> clicked = Event<>(event_queue, L"Clicked");
+
+		REQUIRE(moved.trigger(1, 2));
+		REQUIRE(clicked.trigger());
+		event_queue.processTriggeredEvents(tick_time);
+
+		REQUIRE(moved.trigger(3, 4));
+		event_queue.processTriggeredEvents(tick_time + 16ms);
+
+		REQUIRE(0 == recorder.getDroppedCount());
+	}
+}
+
+TEST_CASE("Event Player Replays A Recording One Tick At A Time", "[events]")
+{
+	const auto path = getLogPath("replay_ticks");
+	recordSession(path, std::chrono::steady_clock::now());
+
+	std::error_condition error;
+	EventPlayer player{path, error};
+	REQUIRE(!error);
+
+	EventQueue event_queue;
+	Event<int, int> moved = Event<int, int>(event_queue, L"Moved");
+	Event<> clicked = Event<>(event_queue, L"Clicked");
+
+	PointEventHandler moved_handler;
+	CountingEventHandler clicked_handler;
+	moved.registerEventHandler(&moved_handler);
+	clicked.registerEventHandler(&clicked_handler);
+
+	player.addEvent(moved);
+	player.addEvent(clicked);
+
+	REQUIRE(2 == player.playNextTick());
+	event_queue.processTriggeredEvents();
+	REQUIRE(std::vector<std::pair<int, int>>{{1, 2}} == moved_handler.points);
+	REQUIRE(1 == clicked_handler.calls);
+
+	REQUIRE(1 == player.playNextTick());
+	event_queue.processTriggeredEvents();
+	REQUIRE(std::vector<std::pair<int, int>>{{1, 2}, {3, 4}} == moved_handler.points);
+
+	REQUIRE(player.isFinished());
+	REQUIRE(0 == player.playNextTick());
+	REQUIRE(0 == player.getSkippedCount());
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Event Player Follows Recorded Tick Times", "[events]")
+{
+	const auto path = getLogPath("replay_times");
+	recordSession(path, std::chrono::steady_clock::now());
+
+	std::error_condition error;
+	EventPlayer player{path, error};
+	REQUIRE(!error);
+
+	EventQueue event_queue;
+	Event<int, int> moved = Event<int, int>(event_queue, L"Moved");
+	player.addEvent(moved);
+
+	// Twice as fast, the second tick is due 8ms into playback.
+	const auto playback_start = std::chrono::steady_clock::time_point{1h};
+	player.start(playback_start, 2.0);
+
+	REQUIRE(1 == player.playUntil(playback_start));
+	REQUIRE(0 == player.playUntil(playback_start + 7ms));
+	REQUIRE(1 == player.playUntil(playback_start + 8ms));
+	REQUIRE(player.isFinished());
+
+	// Clicked was never added.
+	REQUIRE(1 == player.getSkippedCount());
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Event Player Stops At The End Of A Log That Was Never Closed", "[events]")
+{
+	const auto path = getLogPath("never_closed");
+	recordSession(path, std::chrono::steady_clock::now());
+
+	// What a crash leaves behind, the file grown ahead of the log by the recorder's mapping and never cut back.
+	{
+		std::ofstream file{path, std::ios::binary | std::ios::app};
+		const std::vector<char> zeroes(1 << 16, 0);
+		file.write(zeroes.data(), static_cast<std::streamsize>(zeroes.size()));
+	}
+
+	std::error_condition error;
+	EventPlayer player{path, error};
+	REQUIRE(!error);
+
+	EventQueue event_queue;
+	Event<int, int> moved = Event<int, int>(event_queue, L"Moved");
+	Event<> clicked = Event<>(event_queue, L"Clicked");
+	player.addEvent(moved);
+	player.addEvent(clicked);
+
+	REQUIRE(2 == player.playNextTick());
+	REQUIRE(1 == player.playNextTick());
+	REQUIRE(player.isFinished());
+	REQUIRE(0 == player.playNextTick());
+	REQUIRE(0 == player.getSkippedCount());
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Event Player Rejects Files That Are Not Event Logs", "[events]")
+{
+	const auto path = getLogPath("not_a_log");
+	std::ofstream{path} << "not an event log";
+
+	std::error_condition error;
+	EventPlayer player{path, error};
+	REQUIRE(error);
+
+	std::filesystem::remove(path);
+}
@@ -8,8 +8,10 @@ export module EventTests;
 import std;
 import Windows;
 
+import Constants;
 import Event;
 import EventQueue;
+import EventPackageHeader;
 import EventHandlerInterface;
 
 using namespace mt::event;
@@ -76,13 +78,16 @@ TEST_CASE("Event Test Size Assumptions", "[events]")
 	REQUIRE(8 == sizeof(std::tuple<int,int>));
 	REQUIRE(12 == sizeof(std::tuple<int,int,int>));
 
-	REQUIRE(32 == sizeof(Event<>::EventPackage));
+	REQUIRE(16 == sizeof(EventPackageHeader));
 
-	REQUIRE(32 == sizeof(Event<int>::EventPackage));
+	// Parameters of up to 4 bytes fit in the header's padding.
+	REQUIRE(24 == sizeof(Event<>::EventPackage));
+
+	REQUIRE(24 == sizeof(Event<int>::EventPackage));
 
 	REQUIRE(32 == sizeof(Event<int, int>::EventPackage));
 
-	REQUIRE(40 == sizeof(Event<int, int, int>::EventPackage));
+	REQUIRE(32 == sizeof(Event<int, int, int>::EventPackage));
 }
 
 TEST_CASE("Allocation Test", "[events]")
@@ -137,7 +142,7 @@ TEST_CASE("Not Enough memory", "[events]")
 
 TEST_CASE("Exactly Full Roll Over Test", "[events]")
 {
-	EventQueue event_manager{32};
+	EventQueue event_manager{24 + EventQueue::PACKAGE_OVERHEAD};
 	std::list<int> executedEvents;
 
 	Event<int> event2 = Event<int>(event_manager, L"Name");
@@ -152,7 +157,7 @@ TEST_CASE("Exactly Full Roll Over Test", "[events]")
 
 		// this one requires a roll-over;
 		REQUIRE(event2.trigger(1));
-		REQUIRE(32 == event_manager.getUsedSpace());
+		REQUIRE(24 + EventQueue::PACKAGE_OVERHEAD == event_manager.getUsedSpace());
 		REQUIRE(0 == event_manager.getFreeSpace());
 	}
 
@@ -169,7 +174,7 @@ TEST_CASE("Event Manager Capacity", "[events]")
 
 TEST_CASE("Not Enough Room Roll Over Test", "[events]")
 {
-	EventQueue event_manager{40};
+	EventQueue event_manager{40 + EventQueue::PACKAGE_OVERHEAD};
 	std::list<int> executedEvents;
 
 	Event<> event1 = Event<>(event_manager, L"Name");
@@ -177,18 +182,612 @@ TEST_CASE("Not Enough Room Roll Over Test", "[events]")
 	event1.registerEventHandler(&event_handler_1);
 
 	REQUIRE(event1.trigger());
-	REQUIRE(32 == event_manager.getUsedSpace());
-	REQUIRE(8 == event_manager.getFreeSpace());
+	REQUIRE(24 + EventQueue::PACKAGE_OVERHEAD == event_manager.getUsedSpace());
+	REQUIRE(16 == event_manager.getFreeSpace());
 
 	for (auto i = 0; i < 10; ++i)
 	{
 		event_manager.processTriggeredEvents();
 
-		// there is not enough space in the buffer to allocate this from 8 bytes in, so it should roll over.
+		// there is not enough space in the last 16 bytes of the buffer to allocate this, so it should roll over.
 		REQUIRE(event1.trigger());
-		REQUIRE(32 == event_manager.getUsedSpace());
-		REQUIRE(8 == event_manager.getFreeSpace());
+		REQUIRE(24 + EventQueue::PACKAGE_OVERHEAD == event_manager.getUsedSpace());
+		REQUIRE(16 == event_manager.getFreeSpace());
 	}
 
 	requireNotEnoughMemory(event1.trigger());
-}
\ No newline at end of file
+}
+
+TEST_CASE("Lock Free Event Queue Processes Events In Order", "[events]")
+{
+	EventQueue event_queue{1024, EventQueueMode::LOCK_FREE};
+	std::list<int> executedEvents;
+
+	REQUIRE(EventQueueMode::LOCK_FREE == event_queue.getMode());
+
+	Event<> event1 = Event<>(event_queue, L"Name");
+	EventHandler1 event_handler_1{&executedEvents};
+	event1.registerEventHandler(&event_handler_1);
+
+	Event<int> event2 = Event<int>(event_queue, L"Name");
+	EventHandler2 event_handler_2{&executedEvents};
+	event2.registerEventHandler(&event_handler_2);
+
+	for (auto i = 0; i < 100; ++i)
+	{
+		REQUIRE(event1.trigger());
+		REQUIRE(event2.trigger(i));
+		event_queue.processTriggeredEvents();
+
+		REQUIRE(std::list{1, 2} == executedEvents);
+		REQUIRE(0 == event_queue.getUsedSpace());
+		executedEvents.clear();
+	}
+}
+
+struct CountingEventHandler : public EventHandler<int>
+{
+	std::vector<int> counts;
+
+	explicit CountingEventHandler(std::size_t producers)
+		: counts(producers)
+	{}
+
+	void operator()(int producer) noexcept override
+	{
+		++counts[producer];
+	}
+};
+
+TEST_CASE("Lock Free Event Queue Takes Events From Many Threads", "[events]")
+{
+	constexpr int PRODUCERS = 4;
+	constexpr int EVENTS_PER_PRODUCER = 10'000;
+
+	EventQueue event_queue{4096, EventQueueMode::LOCK_FREE};
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	CountingEventHandler event_handler{PRODUCERS};
+	event.registerEventHandler(&event_handler);
+
+	{
+		std::vector<std::jthread> producers;
+
+		for (auto producer = 0; producer < PRODUCERS; ++producer)
+		{
+			producers.emplace_back([&event, producer]() noexcept {
+				for (auto i = 0; i < EVENTS_PER_PRODUCER;)
+				{
+					if (event.trigger(producer)) ++i;
+				}
+			});
+		}
+
+		auto is_done = [&event_handler]() noexcept {
+			return std::ranges::all_of(event_handler.counts, [](int count) { return count == EVENTS_PER_PRODUCER; });
+		};
+
+		while (!is_done()) event_queue.processTriggeredEvents();
+	}
+
+	REQUIRE(0 == event_queue.getUsedSpace());
+}
+
+TEST_CASE("Event Deregisters Handlers By Token", "[events]")
+{
+	EventQueue event_queue;
+	std::list<int> executedEvents;
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	EventHandler2 event_handler_1{&executedEvents};
+	EventHandler2 event_handler_2{&executedEvents};
+
+	auto token_1 = event.registerEventHandler(&event_handler_1);
+	auto token_2 = event.registerEventHandler(&event_handler_2);
+	REQUIRE(2 == event.getEventHandlerCount());
+
+	REQUIRE(event.deregisterEventHandler(token_1));
+	REQUIRE(!event.deregisterEventHandler(token_1));
+	REQUIRE(1 == event.getEventHandlerCount());
+
+	event(1);
+	REQUIRE(std::list{2} == executedEvents);
+
+	REQUIRE(event.deregisterEventHandler(token_2));
+	event(1);
+	REQUIRE(std::list{2} == executedEvents);
+}
+
+// Deregisters a list of handlers, itself included, the first time it is called.
+struct DeregisteringEventHandler : public EventHandler<>
+{
+	Event<>* event{};
+	std::vector<Event<>::token_t> tokens;
+	int calls = 0;
+
+	void operator()() noexcept override
+	{
+		++calls;
+
+		for (auto token : tokens) event->deregisterEventHandler(token);
+	}
+};
+
+struct CountingEventHandler0 : public EventHandler<>
+{
+	int calls = 0;
+
+	void operator()() noexcept override { ++calls; }
+};
+
+TEST_CASE("Event Defers Removal During Dispatch", "[events]")
+{
+	EventQueue event_queue;
+	Event<> event = Event<>(event_queue, L"Name");
+
+	DeregisteringEventHandler deregistering_handler;
+	CountingEventHandler0 before;
+	CountingEventHandler0 after;
+
+	auto before_token = event.registerEventHandler(&before);
+	auto deregistering_token = event.registerEventHandler(&deregistering_handler);
+	event.registerEventHandler(&after);
+
+	deregistering_handler.event = &event;
+	deregistering_handler.tokens = {before_token, deregistering_token};
+
+	// Erasing straight away would move the last handler into the hole and skip it.
+	event();
+	REQUIRE(1 == before.calls);
+	REQUIRE(1 == deregistering_handler.calls);
+	REQUIRE(1 == after.calls);
+	REQUIRE(1 == event.getEventHandlerCount());
+
+	event();
+	REQUIRE(1 == before.calls);
+	REQUIRE(1 == deregistering_handler.calls);
+	REQUIRE(2 == after.calls);
+}
+
+TEST_CASE("Delayed Events Wait For Their Deadline", "[events]")
+{
+	using namespace std::chrono_literals;
+
+	EventQueue event_queue;
+	std::list<int> executedEvents;
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	EventHandler2 event_handler{&executedEvents};
+	event.registerEventHandler(&event_handler);
+
+	const auto now = std::chrono::steady_clock::time_point{10s};
+
+	REQUIRE(event.triggerAt(now + 2s, 2));
+	REQUIRE(event.triggerAt(now + 1s, 1));
+	REQUIRE(2 == event_queue.getDelayedCount());
+
+	event_queue.processTriggeredEvents(now);
+	REQUIRE(executedEvents.empty());
+
+	event_queue.processTriggeredEvents(now + 1s);
+	REQUIRE(std::list{2} == executedEvents);
+	REQUIRE(1 == event_queue.getDelayedCount());
+
+	event_queue.processTriggeredEvents(now + 5s);
+	REQUIRE(std::list{2, 2} == executedEvents);
+	REQUIRE(0 == event_queue.getDelayedCount());
+}
+
+TEST_CASE("Delayed Events Can Wait A Number Of Frames", "[events]")
+{
+	EventQueue event_queue;
+	std::list<int> executedEvents;
+
+	Event<> event = Event<>(event_queue, L"Name");
+	EventHandler1 event_handler{&executedEvents};
+	event.registerEventHandler(&event_handler);
+
+	REQUIRE(event.triggerAfterFrames(3));
+
+	event_queue.processTriggeredEvents();
+	event_queue.processTriggeredEvents();
+	REQUIRE(executedEvents.empty());
+
+	event_queue.processTriggeredEvents();
+	REQUIRE(std::list{1} == executedEvents);
+}
+
+struct RecordingEventHandler : public EventHandler<int>
+{
+	std::vector<int> values;
+
+	void operator()(int value) noexcept override { values.push_back(value); }
+};
+
+TEST_CASE("Coalescing Events Update The Queued Package", "[events]")
+{
+	EventQueue event_queue;
+
+	Event<int> keep_last = Event<int>(event_queue, L"KeepLast", coalesceKeepLast);
+	Event<int> sum = Event<int>(event_queue, L"Sum", coalesceSum);
+	Event<int> max = Event<int>(event_queue, L"Max", coalesceMax);
+	REQUIRE(keep_last.isCoalescing());
+
+	RecordingEventHandler keep_last_handler;
+	RecordingEventHandler sum_handler;
+	RecordingEventHandler max_handler;
+	keep_last.registerEventHandler(&keep_last_handler);
+	sum.registerEventHandler(&sum_handler);
+	max.registerEventHandler(&max_handler);
+
+	for (auto value : {3, 7, 5})
+	{
+		REQUIRE(keep_last.trigger(value));
+		REQUIRE(sum.trigger(value));
+		REQUIRE(max.trigger(value));
+	}
+
+	REQUIRE(3 * (EventQueue::PACKAGE_OVERHEAD + sizeof(Event<int>::EventPackage)) == event_queue.getUsedSpace());
+
+	event_queue.processTriggeredEvents();
+	REQUIRE(std::vector{5} == keep_last_handler.values);
+	REQUIRE(std::vector{15} == sum_handler.values);
+	REQUIRE(std::vector{7} == max_handler.values);
+	REQUIRE(0 == event_queue.getUsedSpace());
+
+	// Once the queue has processed the package, the next trigger queues a new one.
+	REQUIRE(sum.trigger(1));
+	REQUIRE(sum.trigger(2));
+	event_queue.processTriggeredEvents();
+	REQUIRE(std::vector{15, 3} == sum_handler.values);
+}
+
+TEST_CASE("Coalescing Events Keep Their Place In The Queue", "[events]")
+{
+	EventQueue event_queue;
+	std::list<int> executedEvents;
+
+	Event<> coalescing = Event<>(event_queue, L"Coalescing", coalesceKeepLast);
+	Event<int> event = Event<int>(event_queue, L"Name");
+
+	EventHandler1 event_handler_1{&executedEvents};
+	EventHandler2 event_handler_2{&executedEvents};
+	coalescing.registerEventHandler(&event_handler_1);
+	event.registerEventHandler(&event_handler_2);
+
+	REQUIRE(coalescing.trigger());
+	REQUIRE(event.trigger(1));
+	REQUIRE(coalescing.trigger());
+
+	event_queue.processTriggeredEvents();
+	REQUIRE(std::list{1, 2} == executedEvents);
+}
+
+TEST_CASE("Coalescing Events Take A Custom Reducer", "[events]")
+{
+	EventQueue event_queue;
+
+	// Keeps the value with the largest magnitude.
+	auto reducer = [](EventParameters<int>& pending, const EventParameters<int>& next) noexcept {
+		if (std::abs(next.first) > std::abs(pending.first)) pending.first = next.first;
+	};
+
+	Event<int> event = Event<int>(event_queue, L"Name", reducer);
+	RecordingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	REQUIRE(event.trigger(4));
+	REQUIRE(event.trigger(-9));
+	REQUIRE(event.trigger(6));
+
+	event_queue.processTriggeredEvents();
+	REQUIRE(std::vector{-9} == event_handler.values);
+}
+
+TEST_CASE("Growing Event Queue Overflows In Order", "[events]")
+{
+	EventQueue event_queue{64, EventQueueMode::MUTEX, EventQueueOverflow::GROW};
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	RecordingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	for (auto burst = 0; burst < 3; ++burst)
+	{
+		for (auto i = 0; i < 5000; ++i) REQUIRE(event.trigger(i));
+
+		REQUIRE(event_queue.isOverflowing());
+		REQUIRE(1 < event_queue.getOverflowSegmentCount());
+
+		event_queue.processTriggeredEvents();
+
+		REQUIRE(5000 == event_handler.values.size());
+		REQUIRE(std::ranges::equal(event_handler.values, std::views::iota(0, 5000)));
+		REQUIRE(!event_queue.isOverflowing());
+		REQUIRE(0 == event_queue.getOverflowSegmentCount());
+		REQUIRE(0 == event_queue.getUsedSpace());
+
+		event_handler.values.clear();
+	}
+
+	// Once the burst has passed, pushes go to the ring again.
+	REQUIRE(event.trigger(1));
+	REQUIRE(!event_queue.isOverflowing());
+	REQUIRE(EventQueue::PACKAGE_OVERHEAD + sizeof(Event<int>::EventPackage) == event_queue.getUsedSpace());
+}
+
+struct SequenceEventHandler : public EventHandler<int, int>
+{
+	std::vector<int> next_sequences;
+	bool is_in_order = true;
+
+	explicit SequenceEventHandler(std::size_t producers)
+		: next_sequences(producers)
+	{}
+
+	void operator()(int producer, int sequence) noexcept override
+	{
+		is_in_order = is_in_order && next_sequences[producer] == sequence;
+		next_sequences[producer] = sequence + 1;
+	}
+};
+
+TEST_CASE("Growing Lock Free Event Queue Keeps Each Producer In Order", "[events]")
+{
+	constexpr int PRODUCERS = 4;
+	constexpr int EVENTS_PER_PRODUCER = 10'000;
+
+	EventQueue event_queue{256, EventQueueMode::LOCK_FREE, EventQueueOverflow::GROW};
+
+	Event<int, int> event = Event<int, int>(event_queue, L"Name");
+	SequenceEventHandler event_handler{PRODUCERS};
+	event.registerEventHandler(&event_handler);
+
+	{
+		std::vector<std::jthread> producers;
+
+		for (auto producer = 0; producer < PRODUCERS; ++producer)
+		{
+			producers.emplace_back([&event, producer]() noexcept {
+				for (auto i = 0; i < EVENTS_PER_PRODUCER; ++i)
+				{
+					// Never fails, the queue grows instead.
+					if (!event.trigger(producer, i)) std::terminate();
+				}
+			});
+		}
+
+		auto is_done = [&event_handler]() noexcept {
+			return std::ranges::all_of(event_handler.next_sequences, [](int next_sequence) {
+				return next_sequence == EVENTS_PER_PRODUCER;
+			});
+		};
+
+		while (!is_done()) event_queue.processTriggeredEvents();
+	}
+
+	REQUIRE(event_handler.is_in_order);
+	REQUIRE(!event_queue.isOverflowing());
+}
+
+TEST_CASE("Event Queue Statistics Count Pushes And Latency", "[events]")
+{
+	using namespace std::chrono_literals;
+
+	if (!mt::HAS_EVENT_QUEUE_STATISTICS) return;
+
+	constexpr auto PACKAGE_SIZE = sizeof(Event<int>::EventPackage);
+
+	EventQueue event_queue;
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	RecordingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	for (auto i = 0; i < 3; ++i) REQUIRE(event.trigger(i));
+
+	auto statistics = event_queue.getStatistics();
+	REQUIRE(3 == statistics.pushes);
+	REQUIRE(3 * PACKAGE_SIZE == statistics.pushed_bytes);
+	REQUIRE(0 == statistics.pushes_per_frame);
+
+	std::this_thread::sleep_for(2ms);
+	event_queue.processTriggeredEvents();
+
+	statistics = event_queue.getStatistics();
+	REQUIRE(3 == statistics.pushes_per_frame);
+	REQUIRE(3 * PACKAGE_SIZE == statistics.pushed_bytes_per_frame);
+	REQUIRE(3 * (EventQueue::PACKAGE_OVERHEAD + PACKAGE_SIZE) == statistics.used_space_high_water);
+	REQUIRE(3 == statistics.dispatches_per_frame);
+	REQUIRE(2ms <= statistics.mean_latency_per_frame);
+	REQUIRE(statistics.mean_latency_per_frame <= statistics.max_latency_per_frame);
+	REQUIRE(statistics.max_latency_per_frame == statistics.max_latency);
+
+	const auto max_latency = statistics.max_latency;
+
+	// The per frame counts start again, the totals, the high water mark and the largest latency carry over.
+	REQUIRE(event.trigger(3));
+	event_queue.processTriggeredEvents();
+
+	statistics = event_queue.getStatistics();
+	REQUIRE(4 == statistics.pushes);
+	REQUIRE(1 == statistics.pushes_per_frame);
+	REQUIRE(PACKAGE_SIZE == statistics.pushed_bytes_per_frame);
+	REQUIRE(3 * (EventQueue::PACKAGE_OVERHEAD + PACKAGE_SIZE) == statistics.used_space_high_water);
+	REQUIRE(1 == statistics.dispatches_per_frame);
+	REQUIRE(max_latency <= statistics.max_latency);
+}
+
+TEST_CASE("Event Queue Statistics Count Wraparounds", "[events]")
+{
+	if (!mt::HAS_EVENT_QUEUE_STATISTICS) return;
+
+	// Exactly one package fits, so every push after the first starts the ring again.
+	EventQueue event_queue{EventQueue::PACKAGE_OVERHEAD + sizeof(Event<int>::EventPackage)};
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	RecordingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	for (auto i = 0; i < 5; ++i)
+	{
+		REQUIRE(event.trigger(i));
+		event_queue.processTriggeredEvents();
+	}
+
+	REQUIRE(5 == event_queue.getStatistics().wraparounds);
+	REQUIRE(5 == event_queue.getStatistics().pushes);
+}
+
+TEST_CASE("Event Queue Statistics Include The Overflow Chain", "[events]")
+{
+	if (!mt::HAS_EVENT_QUEUE_STATISTICS) return;
+
+	EventQueue event_queue{64, EventQueueMode::LOCK_FREE, EventQueueOverflow::GROW};
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	RecordingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	for (auto i = 0; i < 1000; ++i) REQUIRE(event.trigger(i));
+	REQUIRE(event_queue.isOverflowing());
+
+	event_queue.processTriggeredEvents();
+
+	const auto statistics = event_queue.getStatistics();
+	REQUIRE(1000 == statistics.pushes_per_frame);
+	REQUIRE(1000 == statistics.dispatches_per_frame);
+	REQUIRE(event_queue.getCapacity() < statistics.used_space_high_water);
+}
+
+TEST_CASE("Event Queue Statistics Count Only The Used Part Of Overflow Segments", "[events]")
+{
+	if (!mt::HAS_EVENT_QUEUE_STATISTICS) return;
+
+	constexpr auto PACKAGE_SIZE = sizeof(Event<int>::EventPackage);
+
+	EventQueue event_queue{64, EventQueueMode::LOCK_FREE, EventQueueOverflow::GROW};
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	RecordingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	for (auto i = 0; i < 10; ++i) REQUIRE(event.trigger(i));
+	REQUIRE(event_queue.isOverflowing());
+
+	event_queue.processTriggeredEvents();
+
+	// Far less than the segment the packages were pushed into.
+	const auto max_used_space =
+		event_queue.getCapacity() + 10 * (EventQueue::PACKAGE_OVERHEAD + PACKAGE_SIZE + alignof(std::max_align_t));
+	REQUIRE(max_used_space >= event_queue.getStatistics().used_space_high_water);
+}
+
+struct WakingEventHandler : public EventHandler<int>
+{
+	std::atomic<int> count = 0;
+	std::thread::id thread{};
+
+	void operator()(int) noexcept override
+	{
+		thread = std::this_thread::get_id();
+		count.fetch_add(1, std::memory_order_release);
+		count.notify_all();
+	}
+
+	void waitForCount(int expected_count) noexcept
+	{
+		for (auto current = count.load(std::memory_order_acquire);
+			current != expected_count;
+			current = count.load(std::memory_order_acquire)
+		)
+		{
+			count.wait(current, std::memory_order_acquire);
+		}
+	}
+};
+
+TEST_CASE("Bound Event Queue Wakes Its Consumer Thread", "[events]")
+{
+	EventQueue event_queue{4096, EventQueueMode::LOCK_FREE};
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	WakingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	std::thread::id consumer_thread;
+
+	{
+		std::jthread consumer([&event_queue](std::stop_token stop_token) noexcept {
+			event_queue.runConsumer(stop_token);
+		});
+		consumer_thread = consumer.get_id();
+		event_queue.bindConsumerThread(consumer_thread);
+
+		REQUIRE(consumer_thread == event_queue.getConsumerThread());
+
+		// The consumer is asleep on an empty queue before every trigger.
+		for (auto i = 0; i < 100; ++i)
+		{
+			REQUIRE(event.trigger(i));
+			event_handler.waitForCount(i + 1);
+		}
+
+		// Stopping the consumer wakes it.
+	}
+
+	REQUIRE(consumer_thread == event_handler.thread);
+}
+
+TEST_CASE("Bound Event Queue Takes Events From Many Threads", "[events]")
+{
+	constexpr int PRODUCERS = 4;
+	constexpr int EVENTS_PER_PRODUCER = 10'000;
+
+	EventQueue event_queue{4096, EventQueueMode::LOCK_FREE};
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	WakingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	std::jthread consumer([&event_queue](std::stop_token stop_token) noexcept {
+		event_queue.runConsumer(stop_token);
+	});
+	event_queue.bindConsumerThread(consumer.get_id());
+
+	{
+		std::vector<std::jthread> producers;
+
+		for (auto producer = 0; producer < PRODUCERS; ++producer)
+		{
+			producers.emplace_back([&event, producer]() noexcept {
+				for (auto i = 0; i < EVENTS_PER_PRODUCER;)
+				{
+					if (event.trigger(producer)) ++i;
+				}
+			});
+		}
+	}
+
+	event_handler.waitForCount(PRODUCERS * EVENTS_PER_PRODUCER);
+}
+
+TEST_CASE("Waking An Event Queue Consumer Without Events", "[events]")
+{
+	EventQueue event_queue;
+	event_queue.bindConsumerThread();
+
+	Event<int> event = Event<int>(event_queue, L"Name");
+	RecordingEventHandler event_handler;
+	event.registerEventHandler(&event_handler);
+
+	// A wake that comes before the wait is not lost.
+	event_queue.wakeConsumer();
+	REQUIRE(!event_queue.waitForEvents());
+
+	REQUIRE(event.trigger(1));
+	REQUIRE(event_queue.waitForEvents());
+
+	event_queue.processTriggeredEvents();
+	REQUIRE(std::vector{1} == event_handler.values);
+}
@@ -0,0 +1,53 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+export module FrameArenaTests;
+
+import std.compat;
+
+import FrameArena;
+
+using namespace mt::memory;
+
+TEST_CASE("Frame Arena Rewinds A Frame's Buffer", "[memory]")
+{
+	std::error_condition error;
+	FrameArena arena(2, 256, error);
+
+	REQUIRE(!error);
+
+	auto* first = arena.allocate(16, 16);
+	auto* second = arena.allocate(8, 64);
+
+	REQUIRE(reinterpret_cast<std::uintptr_t>(second) % 64 == 0);
+	REQUIRE(arena.bytesUsed() >= 24);
+
+	// The other frame's buffer is untouched by this frame's allocations.
+	arena.beginFrame(1);
+	REQUIRE(0 == arena.bytesUsed());
+	REQUIRE(first != arena.allocate(16, 16));
+
+	// Coming back around to the first frame hands out the same memory again.
+	arena.beginFrame(0);
+	REQUIRE(first == arena.allocate(16, 16));
+	REQUIRE(0 == arena.overflowAllocations());
+}
+
+TEST_CASE("Frame Arena Overflows To The Upstream Resource", "[memory]")
+{
+	std::error_condition error;
+	FrameArena arena(2, 64, error);
+
+	REQUIRE(!error);
+
+	std::pmr::vector<int> values{&arena};
+
+	for (auto i = 0; i < 64; i++) values.push_back(i);
+
+	REQUIRE(64 == values.size());
+	REQUIRE(63 == values.back());
+	REQUIRE(0 < arena.overflowAllocations());
+	REQUIRE(arena.highWaterMark() <= arena.bytesPerFrame());
+}
@@ -0,0 +1,78 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+export module FramePacketTests;
+
+import std;
+
+import FramePacket;
+
+using namespace mt::memory;
+
+namespace
+{
+	struct TestPacket
+	{
+		std::uint64_t frame = 0;
+		std::uint64_t frame_squared = 0;
+	};
+}
+
+TEST_CASE("Frame Packet Reader Sees The Newest Published Packet", "[memory]")
+{
+	FramePacketExchange<TestPacket> exchange;
+
+	REQUIRE(!exchange.update());
+	REQUIRE(0 == exchange.getReadPacket().frame);
+
+	exchange.getWritePacket() = TestPacket{1, 1};
+	exchange.publish();
+	exchange.getWritePacket() = TestPacket{2, 4};
+	exchange.publish();
+
+	// The first packet was never read, the second one replaced it.
+	REQUIRE(exchange.update());
+	REQUIRE(2 == exchange.getReadPacket().frame);
+
+	// Nothing new, the reader keeps its packet.
+	REQUIRE(!exchange.update());
+	REQUIRE(2 == exchange.getReadPacket().frame);
+
+	exchange.getWritePacket() = TestPacket{3, 9};
+	exchange.publish();
+	REQUIRE(exchange.update());
+	REQUIRE(3 == exchange.getReadPacket().frame);
+}
+
+TEST_CASE("Frame Packet Reader Never Sees A Partial Packet", "[memory]")
+{
+	constexpr std::uint64_t FRAMES = 100'000;
+
+	FramePacketExchange<TestPacket> exchange;
+
+	auto writer = std::jthread([&exchange]() noexcept {
+		for (auto frame = std::uint64_t{1}; frame <= FRAMES; ++frame)
+		{
+			auto& packet = exchange.getWritePacket();
+			packet.frame = frame;
+			packet.frame_squared = frame * frame;
+			exchange.publish();
+		}
+	});
+
+	std::uint64_t last_frame = 0;
+
+	while (last_frame != FRAMES)
+	{
+		if (!exchange.update()) continue;
+
+		const auto& packet = exchange.getReadPacket();
+
+		REQUIRE(packet.frame_squared == packet.frame * packet.frame);
+		REQUIRE(packet.frame > last_frame);
+
+		last_frame = packet.frame;
+	}
+}
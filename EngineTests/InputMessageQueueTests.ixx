@@ -0,0 +1,116 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+export module InputMessageQueueTests;
+
+import std;
+
+import InputMessageQueue;
+import InputModel;
+
+using namespace mt::input;
+using namespace mt::input::model;
+
+namespace
+{
+	const auto WHEEL_INPUT_TYPE =
+		InputType(InputDevice::MOUSE, InputDataType::ONE_DIMENSIONAL, InputContext::NO_CONTEXT);
+}
+
+TEST_CASE("Input Message Queue Hands Messages Over In Order", "[input]")
+{
+	std::error_condition error;
+	auto input_messages = std::make_unique<InputMessageQueue>(error);
+	REQUIRE(!error);
+
+	for (auto i = 0; i < 3; ++i) REQUIRE(input_messages->push(WHEEL_INPUT_TYPE, InputData1D(i)));
+
+	// Nothing is handed over until the pump iteration is published.
+	input_messages->receive();
+	REQUIRE(0 == input_messages->size());
+
+	input_messages->publish();
+	input_messages->receive();
+	REQUIRE(3 == input_messages->size());
+
+	for (auto i = 0; i < 3; ++i)
+	{
+		REQUIRE(i == std::get<InputData1D>(input_messages->front().data).x);
+		input_messages->pop();
+	}
+
+	REQUIRE(0 == input_messages->size());
+}
+
+TEST_CASE("Input Message Queue Pauses When Both Pools Are Full And Resumes Once They Have Room", "[input]")
+{
+	std::error_condition error;
+	auto input_messages = std::make_unique<InputMessageQueue>(error);
+	REQUIRE(!error);
+
+	std::size_t pushed = 0;
+	while (input_messages->push(WHEEL_INPUT_TYPE, InputData1D(0))) ++pushed;
+	input_messages->publish();
+	input_messages->receive();
+
+	// The message pool, then the overflow pool up to its page limit.
+	REQUIRE(InputMessageQueue::CAPACITY == pushed);
+	REQUIRE(InputMessageQueue::CAPACITY == input_messages->size());
+	REQUIRE(!input_messages->isAccepting());
+
+	// The overflow pool is still full.
+	input_messages->pop();
+	input_messages->resume();
+	REQUIRE(!input_messages->isAccepting());
+
+	while (input_messages->size() > 0) input_messages->pop();
+	input_messages->resume();
+	REQUIRE(input_messages->isAccepting());
+	REQUIRE(input_messages->push(WHEEL_INPUT_TYPE, InputData1D(0)));
+}
+
+TEST_CASE("Input Message Queue Accepts And Processes Input At The Same Time", "[input]")
+{
+	constexpr int MESSAGES = 100'000;
+	constexpr int MESSAGES_PER_PUMP = 64;
+
+	std::error_condition error;
+	auto input_messages = std::make_unique<InputMessageQueue>(error);
+	REQUIRE(!error);
+
+	// Stands in for the windows message thread, which publishes once per pump iteration. A dropped message is sent
+	// again once input has resumed.
+	std::jthread message_thread([&input_messages]() noexcept {
+		for (auto i = 0; i < MESSAGES;)
+		{
+			for (auto pumped = 0; pumped < MESSAGES_PER_PUMP && i < MESSAGES && input_messages->isAccepting(); ++pumped)
+			{
+				if (input_messages->push(WHEEL_INPUT_TYPE, InputData1D(i))) ++i;
+			}
+
+			input_messages->publish();
+
+			if (!input_messages->isAccepting()) std::this_thread::yield();
+		}
+	});
+
+	// The tick thread.
+	auto expected = 0;
+	while (expected < MESSAGES)
+	{
+		input_messages->receive();
+
+		for (auto size = input_messages->size(); size > 0; --size)
+		{
+			REQUIRE(expected++ == std::get<InputData1D>(input_messages->front().data).x);
+			input_messages->pop();
+		}
+
+		input_messages->resume();
+	}
+
+	message_thread.join();
+	REQUIRE(0 == input_messages->size());
+}
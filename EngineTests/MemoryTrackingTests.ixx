@@ -0,0 +1,85 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+export module MemoryTrackingTests;
+
+import std;
+
+import MemoryTracking;
+import ObjectPool;
+
+using namespace mt::memory;
+
+TEST_CASE("Tracking Memory Resource Charges Its Tag", "[memory]")
+{
+	MemoryTracker tracker;
+	TrackingMemoryResource memory_resource{MemoryTag::GEOMETRY, std::pmr::new_delete_resource(), &tracker};
+
+	{
+		std::pmr::vector<int> values{&memory_resource};
+		values.reserve(256);
+
+		const auto statistics = tracker.getStatistics(MemoryTag::GEOMETRY);
+		REQUIRE(256 * sizeof(int) <= statistics.live_bytes);
+		REQUIRE(1 == statistics.allocations);
+		REQUIRE(0 == statistics.frees);
+	}
+
+	const auto statistics = tracker.getStatistics(MemoryTag::GEOMETRY);
+	REQUIRE(0 == statistics.live_bytes);
+	REQUIRE(256 * sizeof(int) <= statistics.peak_bytes);
+	REQUIRE(1 == statistics.frees);
+
+	// Nothing leaks into the other tags.
+	REQUIRE(0 == tracker.getStatistics(MemoryTag::INPUT).allocations);
+}
+
+TEST_CASE("Memory Tracker Counts Allocations Per Frame", "[memory]")
+{
+	MemoryTracker tracker;
+
+	tracker.recordAllocation(MemoryTag::EVENT, 16);
+	tracker.recordAllocation(MemoryTag::EVENT, 16);
+	tracker.recordFree(MemoryTag::EVENT, 16);
+	tracker.endFrame();
+
+	auto statistics = tracker.getStatistics(MemoryTag::EVENT);
+	REQUIRE(2 == statistics.allocations_per_frame);
+	REQUIRE(1 == statistics.frees_per_frame);
+	REQUIRE(16 == statistics.live_bytes);
+	REQUIRE(32 == statistics.peak_bytes);
+
+	tracker.recordAllocation(MemoryTag::EVENT, 16);
+	tracker.endFrame();
+
+	statistics = tracker.getStatistics(MemoryTag::EVENT);
+	REQUIRE(1 == statistics.allocations_per_frame);
+	REQUIRE(0 == statistics.frees_per_frame);
+	REQUIRE(!tracker.getReport().empty());
+}
+
+TEST_CASE("Object Pool Reports To The Global Tracker", "[memory]")
+{
+	auto& tracker = MemoryTracker::global();
+	const auto before = tracker.getStatistics(MemoryTag::TIME);
+
+	{
+		std::error_condition error;
+		auto pool = std::make_unique<ObjectPool<std::uint64_t, 16>>(error, MemoryTag::TIME);
+		REQUIRE(!error);
+
+		auto reserved_bytes = tracker.getStatistics(MemoryTag::TIME).reserved_bytes;
+		REQUIRE(before.reserved_bytes + 16 * sizeof(std::uint64_t) == reserved_bytes);
+
+		auto object = pool->allocate(std::uint64_t{42});
+		auto live_bytes = tracker.getStatistics(MemoryTag::TIME).live_bytes;
+		REQUIRE(before.live_bytes + sizeof(std::uint64_t) == live_bytes);
+	}
+
+	const auto after = tracker.getStatistics(MemoryTag::TIME);
+	REQUIRE(before.live_bytes == after.live_bytes);
+	REQUIRE(before.reserved_bytes == after.reserved_bytes);
+	REQUIRE(before.allocations + 1 == after.allocations);
+}
@@ -0,0 +1,318 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+module;
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+export module ObjectPoolTests;
+
+import std;
+
+import BackingStore;
+import LockFreeObjectPool;
+import ObjectPool;
+import PagedObjectPool;
+import ThreadingPolicy;
+
+using namespace mt::memory;
+
+struct PooledObject
+{
+	int value;
+	std::array<std::byte, 60> padding{};
+
+	explicit PooledObject(int value) noexcept
+		: value(value)
+	{}
+};
+
+TEST_CASE("Lock Free Object Pool Allocates To Capacity", "[memory]")
+{
+	std::error_condition error;
+	LockFreeObjectPool<PooledObject, 64> pool{error};
+	REQUIRE(!error);
+
+	std::vector<LockFreeObjectPool<PooledObject, 64>::unique_ptr_t> objects;
+	for (auto i = 0; i < 64; ++i)
+	{
+		auto pointer = pool.allocate(i);
+		REQUIRE(pointer);
+		REQUIRE(i == pointer->value);
+		objects.push_back(std::move(pointer));
+	}
+
+	REQUIRE(64 == pool.size());
+	REQUIRE(!pool.allocate(64));
+
+	objects.pop_back();
+	REQUIRE(63 == pool.size());
+	REQUIRE(pool.allocate(65));
+
+	objects.clear();
+	REQUIRE(0 == pool.size());
+}
+
+using CrossThreadLockFreeObjectPool = LockFreeObjectPool<PooledObject, 256>;
+using CrossThreadMagazineObjectPool = LockFreeObjectPool<PooledObject, 256, 8>;
+using CrossThreadLockFreePolicyObjectPool = ObjectPool<PooledObject, 256, LockFreePolicy>;
+
+TEMPLATE_TEST_CASE(
+	"Lock Free Object Pool Cross Thread Release", "[memory]",
+	CrossThreadLockFreeObjectPool, CrossThreadMagazineObjectPool, CrossThreadLockFreePolicyObjectPool
+)
+{
+	constexpr auto OBJECT_COUNT = 100'000;
+
+	std::error_condition error;
+	auto pool = std::make_unique<TestType>(error);
+	REQUIRE(!error);
+
+	std::mutex handoff_lock;
+	std::queue<typename TestType::unique_ptr_t> handoff;
+	std::atomic<int> released = 0;
+
+	// Mirrors the input manager, objects are allocated on one thread and released on another.
+	auto consumer = std::jthread([&](std::stop_token stop_token) {
+		while (!stop_token.stop_requested() || released < OBJECT_COUNT)
+		{
+			std::scoped_lock lock(handoff_lock);
+			while (!handoff.empty())
+			{
+				handoff.pop();
+				++released;
+			}
+		}
+	});
+
+	for (auto i = 0; i < OBJECT_COUNT;)
+	{
+		if (auto pointer = pool->allocate(i); pointer)
+		{
+			std::scoped_lock lock(handoff_lock);
+			handoff.push(std::move(pointer));
+			++i;
+		}
+	}
+
+	consumer.request_stop();
+	consumer.join();
+
+	REQUIRE(OBJECT_COUNT == released);
+	REQUIRE(0 == pool->size());
+}
+
+TEST_CASE("Lock Free Object Pool Magazines Refill And Flush In Batches", "[memory]")
+{
+	std::error_condition error;
+	LockFreeObjectPool<PooledObject, 64, 8> pool{error};
+	REQUIRE(!error);
+
+	std::vector<LockFreeObjectPool<PooledObject, 64, 8>::unique_ptr_t> objects;
+
+	// The first allocation refills the magazine with a batch, the next seven come straight out of it.
+	for (auto i = 0; i < 8; ++i)
+	{
+		objects.push_back(pool.allocate(i));
+	}
+
+	REQUIRE(8 == pool.size());
+	REQUIRE(1 == pool.getMagazineStatistics().refills);
+
+	objects.push_back(pool.allocate(8));
+	REQUIRE(2 == pool.getMagazineStatistics().refills);
+
+	// Releasing fills the magazine back up, each time it is full half of it goes back to the shared free list.
+	objects.clear();
+	REQUIRE(0 == pool.size());
+	REQUIRE(2 == pool.getMagazineStatistics().flushes);
+
+	// Everything is reachable from a single thread.
+	for (auto i = 0; i < 64; ++i)
+	{
+		auto pointer = pool.allocate(i);
+		REQUIRE(pointer);
+		objects.push_back(std::move(pointer));
+	}
+	REQUIRE(!pool.allocate(64));
+}
+
+TEST_CASE("Lock Free Object Pool On Every Backing Store", "[memory]")
+{
+	auto allocate_to_capacity = []<typename BackingStore>() {
+		std::error_condition error;
+		LockFreeObjectPool<PooledObject, 64, 0, BackingStore> pool{error};
+		REQUIRE(!error);
+
+		std::vector<typename LockFreeObjectPool<PooledObject, 64, 0, BackingStore>::unique_ptr_t> objects;
+		for (auto i = 0; i < 64; ++i)
+		{
+			auto pointer = pool.allocate(i);
+			REQUIRE(pointer);
+			objects.push_back(std::move(pointer));
+		}
+
+		REQUIRE(!pool.allocate(64));
+		REQUIRE(63 == objects.back()->value);
+	};
+
+	allocate_to_capacity.operator()<MallocBackingStore>();
+	allocate_to_capacity.operator()<PrefaultedBackingStore>();
+	allocate_to_capacity.operator()<LockedBackingStore>();
+	allocate_to_capacity.operator()<LargePageBackingStore>();
+}
+
+TEST_CASE("Object Pool Allocates And Releases In Batches", "[memory]")
+{
+	using Pool = ObjectPool<PooledObject, 16>;
+
+	std::error_condition error;
+	Pool pool{error};
+	REQUIRE(!error);
+
+	std::array<Pool::unique_ptr_t, 12> first;
+	REQUIRE(12 == pool.allocate_n(std::span(first), 7));
+	REQUIRE(12 == pool.size());
+	REQUIRE(7 == first.back()->value);
+
+	// Only four slots are left, the rest of the batch stays empty.
+	std::array<Pool::unique_ptr_t, 8> second;
+	REQUIRE(4 == pool.allocate_n(std::span(second), 9));
+	REQUIRE(16 == pool.size());
+	REQUIRE(second[3]);
+	REQUIRE(!second[4]);
+
+	REQUIRE(12 == pool.release_n(std::span(first)));
+	REQUIRE(4 == pool.size());
+	REQUIRE(!first.front());
+
+	REQUIRE(4 == pool.release_n(std::span(second)));
+	REQUIRE(0 == pool.size());
+}
+
+TEST_CASE("Object Pool Reset Destroys Every Live Object", "[memory]")
+{
+	static int destroyed = 0;
+
+	struct Counted
+	{
+		~Counted() { ++destroyed; }
+	};
+
+	using Pool = ObjectPool<Counted, 8>;
+
+	std::error_condition error;
+	Pool pool{error};
+	REQUIRE(!error);
+
+	std::array<Pool::unique_ptr_t, 5> objects;
+	REQUIRE(5 == pool.allocate_n(std::span(objects)));
+
+	for (auto& object : objects) static_cast<void>(object.release());
+
+	pool.reset();
+	REQUIRE(5 == destroyed);
+	REQUIRE(0 == pool.size());
+
+	std::array<Pool::unique_ptr_t, 8> all;
+	REQUIRE(8 == pool.allocate_n(std::span(all)));
+}
+
+TEST_CASE("Object Pool Visits Live Objects From Its Occupancy Bitmap", "[memory]")
+{
+	using Pool = ObjectPool<PooledObject, 1024>;
+
+	std::error_condition error;
+	auto pool = std::make_unique<Pool>(error);
+	REQUIRE(!error);
+
+	std::vector<Pool::unique_ptr_t> objects;
+	for (auto i = 0; i < 1024; ++i) objects.push_back(pool->allocate(i));
+
+	// Slots are scanned in groups of 256. Live objects in the first and last group leave the two groups between them
+	// empty, so they are skipped, and the last group is only partly used.
+	for (auto i = 0; i < 1024; ++i)
+	{
+		if (i != 3 && i != 900) objects[i].reset();
+	}
+
+	REQUIRE(2 == pool->size());
+
+	std::vector<int> visited;
+	pool->for_each_live([&](PooledObject& object) { visited.push_back(object.value); });
+	REQUIRE(std::vector<int>{3, 900} == visited);
+
+	const auto occupancy = pool->getOccupancy();
+	REQUIRE(16 == occupancy.size());
+	REQUIRE(std::ranges::all_of(occupancy.begin() + 4, occupancy.begin() + 12, [](auto word) { return word == 0; }));
+
+	auto live = 0;
+	for (auto word : occupancy) live += std::popcount(word);
+	REQUIRE(2 == live);
+
+	// Once the only object in the first group is gone the scan starts with a skip as well.
+	objects[3].reset();
+	visited.clear();
+	pool->for_each_live([&](PooledObject& object) { visited.push_back(object.value); });
+	REQUIRE(std::vector<int>{900} == visited);
+
+	objects.clear();
+	REQUIRE(0 == pool->size());
+}
+
+TEST_CASE("Single Threaded Object Pool Reuses The Most Recently Released Slot", "[memory]")
+{
+	using Pool = ObjectPool<PooledObject, 4, SingleThreadedPolicy>;
+
+	std::error_condition error;
+	Pool pool{error};
+	REQUIRE(!error);
+
+	auto first = pool.allocate(1);
+	auto second = pool.allocate(2);
+	REQUIRE(first.get() < second.get());
+
+	// The free list lives in the slots and is last in first out, so the slot just released is still warm in cache.
+	auto* released = second.get();
+	second.reset();
+	REQUIRE(released == pool.allocate(3).get());
+
+	std::array<Pool::unique_ptr_t, 4> rest;
+	REQUIRE(3 == pool.allocate_n(std::span(rest), 4));
+	REQUIRE(4 == pool.size());
+}
+
+TEST_CASE("Paged Object Pool Grows Without Moving Objects", "[memory]")
+{
+	using Pool = PagedObjectPool<PooledObject, 16>;
+
+	std::error_condition error;
+	Pool pool{error, 1};
+	REQUIRE(!error);
+	REQUIRE(1 == pool.pageCount());
+
+	const auto count = Pool::objectsPerPage() * 3 + 1;
+
+	std::vector<Pool::unique_ptr_t> objects;
+	std::vector<PooledObject*> addresses;
+	for (auto i = 0; i < static_cast<int>(count); ++i)
+	{
+		auto pointer = pool.allocate(i);
+		REQUIRE(pointer);
+		addresses.push_back(pointer.get());
+		objects.push_back(std::move(pointer));
+	}
+
+	REQUIRE(4 == pool.pageCount());
+	REQUIRE(count == pool.size());
+
+	for (auto i = std::size_t{0}; i < count; ++i)
+	{
+		REQUIRE(addresses[i] == objects[i].get());
+		REQUIRE(static_cast<int>(i) == objects[i]->value);
+	}
+
+	// Only one empty page is kept around once everything is released.
+	objects.clear();
+	REQUIRE(0 == pool.size());
+	REQUIRE(1 == pool.pageCount());
+}
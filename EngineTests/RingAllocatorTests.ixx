@@ -0,0 +1,239 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+export module RingAllocatorTests;
+
+import std.compat;
+
+import RingAllocator;
+import ThreadingPolicy;
+
+using namespace mt::memory;
+
+TEST_CASE("Ring Allocator Hands Out Records In Order", "[memory]")
+{
+	std::error_condition error;
+	RingAllocator<SingleThreadedPolicy> ring(64, error);
+
+	REQUIRE(!error);
+	REQUIRE(nullptr == ring.front());
+
+	auto first = ring.allocate(16);
+	auto second = ring.allocate(8);
+	REQUIRE(first);
+	REQUIRE(second);
+
+	std::memset(first.data, 1, 16);
+	std::memset(second.data, 2, 8);
+
+	// Nothing is visible to the consumer until it has been committed.
+	REQUIRE(nullptr == ring.front());
+	ring.commit(first);
+	ring.commit(second);
+
+	REQUIRE(first.data == ring.front());
+	ring.release(16);
+	REQUIRE(second.data == ring.front());
+	ring.release(8);
+
+	REQUIRE(nullptr == ring.front());
+	REQUIRE(0 == ring.getUsedSpace());
+	REQUIRE(ring.getCommitCursor() == ring.getReleaseCursor());
+}
+
+TEST_CASE("Ring Allocator Aligns Records", "[memory]")
+{
+	std::error_condition error;
+	RingAllocator<SingleThreadedPolicy> ring(256, error);
+
+	auto small = ring.allocate(1, 1);
+	auto aligned = ring.allocate(8, 64);
+	REQUIRE(reinterpret_cast<std::uintptr_t>(aligned.data) % 64 == 0);
+
+	ring.commit(small);
+	ring.commit(aligned);
+
+	REQUIRE(small.data == ring.front(1));
+	ring.release(1);
+	REQUIRE(aligned.data == ring.front(64));
+	ring.release(8);
+	REQUIRE(0 == ring.getUsedSpace());
+}
+
+TEST_CASE("Ring Allocator Rolls Over When A Record Does Not Fit", "[memory]")
+{
+	std::error_condition error;
+	RingAllocator<SingleThreadedPolicy> ring(40, error);
+
+	auto first = ring.allocate(32, 8);
+	ring.commit(first);
+	REQUIRE(32 == ring.getUsedSpace());
+	REQUIRE(8 == ring.getFreeSpace());
+
+	// Neither end of the buffer has room while the first record is live.
+	REQUIRE(!ring.allocate(16, 8));
+
+	REQUIRE(first.data == ring.front(8));
+	ring.release(32);
+
+	auto second = ring.allocate(16, 8);
+	ring.commit(second);
+	REQUIRE(first.data == second.data);
+	REQUIRE(16 == ring.getUsedSpace());
+
+	REQUIRE(second.data == ring.front(8));
+	ring.release(16);
+	REQUIRE(0 == ring.getUsedSpace());
+	REQUIRE(40 == ring.getFreeSpace());
+}
+
+TEST_CASE("Ring Allocator Is Full At Exactly Its Capacity", "[memory]")
+{
+	std::error_condition error;
+	RingAllocator<SingleThreadedPolicy> ring(32, error);
+
+	for (auto i = 0; i < 10; ++i)
+	{
+		auto allocation = ring.allocate(32, 8);
+		REQUIRE(allocation);
+		ring.commit(allocation);
+
+		REQUIRE(0 == ring.getFreeSpace());
+		REQUIRE(!ring.allocate(1, 1));
+
+		REQUIRE(allocation.data == ring.front(8));
+		ring.release(32);
+	}
+}
+
+TEST_CASE("Ring Allocator Takes Records From Many Producers", "[memory]")
+{
+	constexpr std::size_t PRODUCERS = 4;
+	constexpr std::size_t RECORDS_PER_PRODUCER = 10'000;
+
+	std::error_condition error;
+	RingAllocator<LockFreePolicy> ring(1024, error);
+
+	std::array<std::size_t, PRODUCERS> next_record{};
+	std::size_t consumed = 0;
+
+	{
+		std::vector<std::jthread> producers;
+
+		for (auto producer = std::size_t{0}; producer < PRODUCERS; ++producer)
+		{
+			producers.emplace_back([&ring, producer]() noexcept {
+				for (auto record = std::size_t{0}; record < RECORDS_PER_PRODUCER;)
+				{
+					auto allocation = ring.allocate(2 * sizeof(std::size_t), alignof(std::size_t));
+
+					if (!allocation) continue;
+
+					const std::array<std::size_t, 2> contents{producer, record++};
+					std::memcpy(allocation.data, contents.data(), sizeof(contents));
+
+					ring.commit(allocation);
+				}
+			});
+		}
+
+		while (consumed < PRODUCERS * RECORDS_PER_PRODUCER)
+		{
+			auto record = ring.front(alignof(std::size_t));
+
+			if (!record) continue;
+
+			std::array<std::size_t, 2> contents{};
+			std::memcpy(contents.data(), record, sizeof(contents));
+
+			// Each producer's records come out in the order it made them.
+			REQUIRE(contents[1] == next_record[contents[0]]++);
+
+			ring.release(sizeof(contents));
+			++consumed;
+		}
+	}
+
+	REQUIRE(0 == ring.getUsedSpace());
+}
+
+TEST_CASE("Lock Free Ring Allocator Commits Out Of Order", "[memory]")
+{
+	std::error_condition error;
+	RingAllocator<LockFreePolicy> ring(256, error);
+
+	auto first = ring.allocate(16);
+	auto second = ring.allocate(16);
+
+	// The second producer does not wait for the first, but the consumer still reads in allocation order.
+	ring.commit(second);
+	REQUIRE(nullptr == ring.front());
+
+	ring.commit(first);
+	REQUIRE(first.data == ring.front());
+	ring.release(16);
+	REQUIRE(second.data == ring.front());
+	ring.release(16);
+
+	REQUIRE(nullptr == ring.front());
+	REQUIRE(0 == ring.getUsedSpace());
+}
+
+TEST_CASE("Lock Free Ring Allocator Rolls Over", "[memory]")
+{
+	std::error_condition error;
+	RingAllocator<LockFreePolicy> ring(64, error);
+
+	for (auto i = 0; i < 10; ++i)
+	{
+		// A record and its stamp take 24 bytes, so every third one rolls over.
+		auto allocation = ring.allocate(16, 8);
+		REQUIRE(allocation);
+		std::memset(allocation.data, i, 16);
+		ring.commit(allocation);
+
+		auto record = ring.front(8);
+		REQUIRE(allocation.data == record);
+		REQUIRE(std::to_integer<int>(record[15]) == i);
+		ring.release(16);
+	}
+
+	REQUIRE(0 == ring.getUsedSpace());
+}
+
+TEST_CASE("Lock Free Ring Allocator Ignores Stale Payloads", "[memory]")
+{
+	std::error_condition error;
+	RingAllocator<LockFreePolicy> ring(64, error);
+
+	// The fifth record's stamp lands on the second word of this payload, and would be 81.
+	auto first = ring.allocate(24, 8);
+	REQUIRE(first);
+	const std::array<std::uint64_t, 3> contents{0, 81, 0};
+	std::memcpy(first.data, contents.data(), sizeof(contents));
+	ring.commit(first);
+
+	REQUIRE(first.data == ring.front(8));
+	ring.release(24);
+
+	for (auto i = 0; i < 3; ++i)
+	{
+		auto allocation = ring.allocate(8, 8);
+		REQUIRE(allocation);
+		ring.commit(allocation);
+
+		REQUIRE(allocation.data == ring.front(8));
+		ring.release(8);
+	}
+
+	auto fifth = ring.allocate(8, 8);
+	REQUIRE(fifth);
+	REQUIRE(fifth.data == first.data + 16);
+	REQUIRE(nullptr == ring.front(8));
+
+	ring.commit(fifth);
+	REQUIRE(fifth.data == ring.front(8));
+	ring.release(8);
+}
@@ -0,0 +1,69 @@
+// Copyright 2023 Micho Todorovich, all rights reserved.
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+export module SlotMapTests;
+
+import std;
+
+import SlotMap;
+
+using namespace mt::memory;
+
+TEST_CASE("Slot Map Lookup And Erase", "[memory]")
+{
+	SlotMap<int> slot_map;
+
+	auto first = slot_map.insert(1);
+	auto second = slot_map.insert(2);
+	auto third = slot_map.insert(3);
+
+	REQUIRE(3 == slot_map.size());
+	REQUIRE(2 == *slot_map.get(second));
+
+	REQUIRE(slot_map.erase(first));
+	REQUIRE(!slot_map.erase(first));
+
+	// The last object is moved into the hole, the remaining handles still resolve.
+	REQUIRE(2 == slot_map.size());
+	REQUIRE(nullptr == slot_map.get(first));
+	REQUIRE(2 == *slot_map.get(second));
+	REQUIRE(3 == *slot_map.get(third));
+	REQUIRE(std::vector{3, 2} == std::vector<int>(slot_map.begin(), slot_map.end()));
+}
+
+TEST_CASE("Slot Map Stale Handles Do Not Resolve", "[memory]")
+{
+	SlotMap<int> slot_map;
+
+	auto stale = slot_map.insert(1);
+	REQUIRE(slot_map.erase(stale));
+
+	// The slot is reused, but with a new generation.
+	auto reused = slot_map.insert(2);
+	REQUIRE(stale.index == reused.index);
+	REQUIRE(stale.generation != reused.generation);
+	REQUIRE(!slot_map.contains(stale));
+	REQUIRE(2 == *slot_map.get(reused));
+
+	slot_map.clear();
+	REQUIRE(slot_map.empty());
+	REQUIRE(!slot_map.contains(reused));
+}
+
+TEST_CASE("Slot Map Allocates From Its Memory Resource", "[memory]")
+{
+	std::array<std::byte, 4096> buffer;
+	std::pmr::monotonic_buffer_resource memory_resource{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+	SlotMap<int> slot_map{&memory_resource};
+
+	auto handle = slot_map.insert(7);
+
+	REQUIRE(7 == *slot_map.get(handle));
+
+	const auto* object = slot_map.get(handle);
+	REQUIRE(reinterpret_cast<const std::byte*>(object) >= buffer.data());
+	REQUIRE(reinterpret_cast<const std::byte*>(object) < buffer.data() + buffer.size());
+}